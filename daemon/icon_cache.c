@@ -0,0 +1,470 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <Elementary.h>
+
+#include "common.h"
+#include "icon_cache.h"
+
+#define QP_ICON_CACHE_MAX_BYTES	(4 * 1024 * 1024)
+#define QP_ICON_CACHE_KEY_LEN	512
+
+/*
+ * A hidden image object per entry keeps the decoded pixels referenced
+ * in the evas image cache, icons loading the same file with the same
+ * load options share them instead of decoding again. The image cache
+ * belongs to a canvas, so keys name the canvas and other windows get
+ * entries of their own.
+ */
+#define QP_ICON_CACHE_REQUEST_KEY	"qp_icon_cache_request"
+
+/* pending async load of an icon */
+typedef struct _qp_icon_cache_request {
+	Evas_Object *icon;
+	Evas_Object *loader;
+	char *key;
+	char *path;
+	int size;
+} qp_icon_cache_request;
+
+typedef struct _qp_icon_cache_entry {
+	char *key;
+	Evas_Object *holder;
+	int bytes;
+	GList *link;
+} qp_icon_cache_entry;
+
+static GHashTable *g_icon_cache;
+/* most recently used first */
+static GQueue g_icon_cache_lru = G_QUEUE_INIT;
+static int g_icon_cache_bytes;
+static qp_icon_cache_stats g_icon_cache_stats;
+
+/* loaders done with, deleted outside their preload callbacks */
+static GList *g_icon_cache_trash;
+static Ecore_Idler *g_icon_cache_trash_idler;
+
+static void _icon_cache_icon_del_cb(void *data, Evas *e, Evas_Object *obj,
+				void *event_info);
+
+static void _icon_cache_holder_del_cb(void *data, Evas *e, Evas_Object *obj,
+				void *event_info)
+{
+	qp_icon_cache_entry *entry = data;
+
+	/* canvas of the holder is going away */
+	entry->holder = NULL;
+	g_hash_table_remove(g_icon_cache, entry->key);
+}
+
+static void _icon_cache_entry_free(gpointer data)
+{
+	qp_icon_cache_entry *entry = data;
+
+	if (!entry)
+		return;
+
+	g_queue_delete_link(&g_icon_cache_lru, entry->link);
+	g_icon_cache_bytes -= entry->bytes;
+
+	if (entry->holder) {
+		evas_object_event_callback_del_full(entry->holder,
+				EVAS_CALLBACK_DEL, _icon_cache_holder_del_cb,
+				entry);
+		evas_object_del(entry->holder);
+	}
+
+	free(entry->key);
+	free(entry);
+}
+
+static void _icon_cache_evict_until(int bytes)
+{
+	qp_icon_cache_entry *entry = NULL;
+
+	while (g_icon_cache_bytes > bytes
+	       && !g_queue_is_empty(&g_icon_cache_lru)) {
+		entry = g_queue_peek_tail(&g_icon_cache_lru);
+		g_hash_table_remove(g_icon_cache, entry->key);
+		g_icon_cache_stats.evictions++;
+	}
+}
+
+/* image of the file with its header read, pixels are not decoded yet */
+static Evas_Object *_icon_cache_holder_add(Evas *evas, const char *path,
+					int size)
+{
+	Evas_Object *holder = NULL;
+
+	holder = evas_object_image_add(evas);
+	retif(holder == NULL, NULL, "fail to add holder image");
+
+	if (size > 0)
+		evas_object_image_load_size_set(holder, size, size);
+
+	evas_object_image_file_set(holder, path, NULL);
+	if (evas_object_image_load_error_get(holder) != EVAS_LOAD_ERROR_NONE) {
+		evas_object_del(holder);
+		return NULL;
+	}
+
+	return holder;
+}
+
+/* takes the decoded holder, deleted on failure */
+static qp_icon_cache_entry *_icon_cache_entry_add(const char *key,
+						Evas_Object *holder)
+{
+	qp_icon_cache_entry *entry = NULL;
+	qp_icon_cache_entry *old = NULL;
+	int w = 0, h = 0;
+
+	evas_object_image_size_get(holder, &w, &h);
+
+	entry = calloc(1, sizeof(qp_icon_cache_entry));
+	if (!entry) {
+		evas_object_del(holder);
+		return NULL;
+	}
+
+	entry->key = strdup(key);
+	if (!entry->key) {
+		evas_object_del(holder);
+		free(entry);
+		return NULL;
+	}
+
+	entry->holder = holder;
+	entry->bytes = w * h * 4;
+	evas_object_event_callback_add(holder, EVAS_CALLBACK_DEL,
+			_icon_cache_holder_del_cb, entry);
+
+	g_queue_push_head(&g_icon_cache_lru, entry);
+	entry->link = g_queue_peek_head_link(&g_icon_cache_lru);
+	g_icon_cache_bytes += entry->bytes;
+
+	g_hash_table_insert(g_icon_cache, entry->key, entry);
+
+	/* keep the newest one even if it is larger than the cache */
+	while (g_icon_cache_bytes > QP_ICON_CACHE_MAX_BYTES) {
+		old = g_queue_peek_tail(&g_icon_cache_lru);
+		if (old == entry)
+			break;
+
+		g_hash_table_remove(g_icon_cache, old->key);
+		g_icon_cache_stats.evictions++;
+	}
+
+	return entry;
+}
+
+static qp_icon_cache_entry *_icon_cache_entry_new(Evas *evas, const char *key,
+						const char *path, int size)
+{
+	Evas_Object *holder = NULL;
+	void *pixels = NULL;
+
+	holder = _icon_cache_holder_add(evas, path, size);
+	if (!holder)
+		return NULL;
+
+	/* decode now, the holder is never rendered */
+	pixels = evas_object_image_data_get(holder, EINA_FALSE);
+	if (pixels)
+		evas_object_image_data_set(holder, pixels);
+
+	return _icon_cache_entry_add(key, holder);
+}
+
+static int _icon_cache_make_key(Evas *evas, const char *path, int size,
+				char *buf, int buf_len)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0)
+		return 0;
+
+	/* a rewritten file gets a new entry, the old one ages out */
+	if (snprintf(buf, buf_len, "%p:%ld:%d:%s", evas, (long)st.st_mtime,
+			size, path) >= buf_len)
+		return 0;
+
+	return 1;
+}
+
+static void _icon_cache_trash_del_cb(void *data, Evas *e, Evas_Object *obj,
+				void *event_info)
+{
+	/* canvas went away first */
+	g_icon_cache_trash = g_list_remove(g_icon_cache_trash, obj);
+}
+
+static void _icon_cache_trash_empty(void)
+{
+	Evas_Object *loader = NULL;
+
+	while (g_icon_cache_trash) {
+		loader = g_icon_cache_trash->data;
+		g_icon_cache_trash = g_list_delete_link(g_icon_cache_trash,
+						g_icon_cache_trash);
+
+		evas_object_event_callback_del_full(loader, EVAS_CALLBACK_DEL,
+				_icon_cache_trash_del_cb, NULL);
+		evas_object_del(loader);
+	}
+}
+
+static Eina_Bool _icon_cache_trash_idler_cb(void *data)
+{
+	g_icon_cache_trash_idler = NULL;
+
+	_icon_cache_trash_empty();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void _icon_cache_loader_trash(Evas_Object *loader)
+{
+	evas_object_event_callback_add(loader, EVAS_CALLBACK_DEL,
+			_icon_cache_trash_del_cb, NULL);
+	g_icon_cache_trash = g_list_prepend(g_icon_cache_trash, loader);
+
+	if (!g_icon_cache_trash_idler)
+		g_icon_cache_trash_idler = ecore_idler_add(
+				_icon_cache_trash_idler_cb, NULL);
+}
+
+static void _icon_cache_request_free(qp_icon_cache_request *req)
+{
+	evas_object_data_del(req->icon, QP_ICON_CACHE_REQUEST_KEY);
+	evas_object_event_callback_del_full(req->icon, EVAS_CALLBACK_DEL,
+			_icon_cache_icon_del_cb, req);
+
+	free(req->key);
+	free(req->path);
+	free(req);
+}
+
+static void _icon_cache_preloaded_cb(void *data, Evas *e, Evas_Object *obj,
+				void *event_info)
+{
+	qp_icon_cache_request *req = data;
+	Evas_Object *icon = req->icon;
+	Evas_Object *loader = req->loader;
+	char *path = req->path;
+	int size = req->size;
+
+	evas_object_event_callback_del_full(loader,
+			EVAS_CALLBACK_IMAGE_PRELOADED,
+			_icon_cache_preloaded_cb, req);
+
+	/* the decoded loader becomes the entry holding the pixels */
+	req->path = NULL;
+	if (g_icon_cache && !g_hash_table_lookup(g_icon_cache, req->key))
+		_icon_cache_entry_add(req->key, loader);
+	else
+		_icon_cache_loader_trash(loader);
+
+	_icon_cache_request_free(req);
+
+	g_icon_cache_stats.loads++;
+
+	elm_icon_prescale_set(icon, size);
+	elm_icon_file_set(icon, path, NULL);
+
+	free(path);
+}
+
+static void _icon_cache_icon_del_cb(void *data, Evas *e, Evas_Object *obj,
+				void *event_info)
+{
+	quickpanel_icon_cache_cancel(obj);
+}
+
+void quickpanel_icon_cache_init(void)
+{
+	if (g_icon_cache)
+		return;
+
+	/* keys belong to the entries */
+	g_icon_cache = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+					_icon_cache_entry_free);
+	memset(&g_icon_cache_stats, 0x00, sizeof(g_icon_cache_stats));
+}
+
+void quickpanel_icon_cache_fini(void)
+{
+	if (!g_icon_cache)
+		return;
+
+	INFO("icon cache hits[%u] misses[%u] evictions[%u] bytes[%d]",
+		g_icon_cache_stats.hits, g_icon_cache_stats.misses,
+		g_icon_cache_stats.evictions, g_icon_cache_bytes);
+
+	if (g_icon_cache_trash_idler) {
+		ecore_idler_del(g_icon_cache_trash_idler);
+		g_icon_cache_trash_idler = NULL;
+	}
+	_icon_cache_trash_empty();
+
+	g_hash_table_destroy(g_icon_cache);
+	g_icon_cache = NULL;
+}
+
+Eina_Bool quickpanel_icon_cache_file_set(Evas_Object *icon, const char *path,
+					int size)
+{
+	qp_icon_cache_entry *entry = NULL;
+	char key[QP_ICON_CACHE_KEY_LEN] = { 0, };
+
+	retif(icon == NULL || path == NULL, EINA_FALSE, "Invalid parameter!");
+
+	/* a late async load must not replace this one */
+	quickpanel_icon_cache_cancel(icon);
+
+	elm_icon_prescale_set(icon, size);
+
+	if (!g_icon_cache
+	    || !_icon_cache_make_key(evas_object_evas_get(icon), path, size,
+				key, sizeof(key)))
+		return elm_icon_file_set(icon, path, NULL);
+
+	entry = g_hash_table_lookup(g_icon_cache, key);
+	if (entry) {
+		g_icon_cache_stats.hits++;
+
+		g_queue_unlink(&g_icon_cache_lru, entry->link);
+		g_queue_push_head_link(&g_icon_cache_lru, entry->link);
+	} else {
+		g_icon_cache_stats.misses++;
+
+		if (!_icon_cache_entry_new(evas_object_evas_get(icon), key,
+					path, size))
+			DBG("%s is not cached", path);
+	}
+
+	return elm_icon_file_set(icon, path, NULL);
+}
+
+Eina_Bool quickpanel_icon_cache_file_set_async(Evas_Object *icon,
+					const char *path, int size,
+					const char *placeholder)
+{
+	qp_icon_cache_request *req = NULL;
+	Evas_Object *loader = NULL;
+	char key[QP_ICON_CACHE_KEY_LEN] = { 0, };
+
+	retif(icon == NULL || path == NULL, EINA_FALSE, "Invalid parameter!");
+
+	quickpanel_icon_cache_cancel(icon);
+
+	if (!g_icon_cache
+	    || !_icon_cache_make_key(evas_object_evas_get(icon), path, size,
+				key, sizeof(key)))
+		return quickpanel_icon_cache_file_set(icon, path, size);
+
+	/* decoded already, nothing to wait for */
+	if (g_hash_table_lookup(g_icon_cache, key))
+		return quickpanel_icon_cache_file_set(icon, path, size);
+
+	g_icon_cache_stats.misses++;
+
+	loader = _icon_cache_holder_add(evas_object_evas_get(icon), path,
+					size);
+	retif(loader == NULL, EINA_FALSE, "fail to load %s", path);
+
+	req = calloc(1, sizeof(qp_icon_cache_request));
+	if (req) {
+		req->key = strdup(key);
+		req->path = strdup(path);
+	}
+	if (!req || !req->key || !req->path) {
+		ERR("fail to alloc request");
+		if (req) {
+			free(req->key);
+			free(req->path);
+			free(req);
+		}
+		evas_object_del(loader);
+		return EINA_FALSE;
+	}
+
+	req->icon = icon;
+	req->loader = loader;
+	req->size = size;
+
+	if (placeholder)
+		quickpanel_icon_cache_file_set(icon, placeholder, 0);
+
+	/* set up before preloading, a cached image completes at once */
+	evas_object_data_set(icon, QP_ICON_CACHE_REQUEST_KEY, req);
+	evas_object_event_callback_add(icon, EVAS_CALLBACK_DEL,
+			_icon_cache_icon_del_cb, req);
+	evas_object_event_callback_add(loader, EVAS_CALLBACK_IMAGE_PRELOADED,
+			_icon_cache_preloaded_cb, req);
+
+	g_icon_cache_stats.pending++;
+	evas_object_image_preload(loader, EINA_FALSE);
+
+	return EINA_TRUE;
+}
+
+void quickpanel_icon_cache_cancel(Evas_Object *icon)
+{
+	qp_icon_cache_request *req = NULL;
+
+	if (!icon)
+		return;
+
+	req = evas_object_data_get(icon, QP_ICON_CACHE_REQUEST_KEY);
+	if (!req)
+		return;
+
+	evas_object_event_callback_del_full(req->loader,
+			EVAS_CALLBACK_IMAGE_PRELOADED,
+			_icon_cache_preloaded_cb, req);
+	evas_object_image_preload(req->loader, EINA_TRUE);
+	evas_object_del(req->loader);
+
+	_icon_cache_request_free(req);
+
+	g_icon_cache_stats.cancels++;
+}
+
+void quickpanel_icon_cache_trim(int bytes)
+{
+	if (!g_icon_cache)
+		return;
+
+	_icon_cache_evict_until(bytes > 0 ? bytes : 0);
+
+	DBG("icon cache trimmed to %d bytes, %d entries", g_icon_cache_bytes,
+		g_hash_table_size(g_icon_cache));
+}
+
+void quickpanel_icon_cache_get_stats(qp_icon_cache_stats *stats)
+{
+	retif(stats == NULL, , "Invalid parameter!");
+
+	*stats = g_icon_cache_stats;
+	stats->bytes = g_icon_cache_bytes;
+	stats->entries = g_icon_cache ? g_hash_table_size(g_icon_cache) : 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QP_ICON_CACHE_H__
+#define __QP_ICON_CACHE_H__
+
+#include <Elementary.h>
+
+typedef struct _qp_icon_cache_stats {
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int evictions;
+	/* async loads started, finished and cancelled */
+	unsigned int pending;
+	unsigned int loads;
+	unsigned int cancels;
+	/* decoded pixels kept alive, in bytes */
+	int bytes;
+	int entries;
+} qp_icon_cache_stats;
+
+void quickpanel_icon_cache_init(void);
+void quickpanel_icon_cache_fini(void);
+
+/*
+ * elm_icon_file_set() keeping the decoded image alive in the canvas of
+ * the icon, size is the prescale size, 0 to load the image as is
+ */
+Eina_Bool quickpanel_icon_cache_file_set(Evas_Object *icon, const char *path,
+					int size);
+
+/*
+ * same, an image not decoded yet is decoded off the main loop by evas
+ * preload while the icon shows the placeholder, if any. returns
+ * EINA_FALSE if the file cannot be loaded.
+ */
+Eina_Bool quickpanel_icon_cache_file_set_async(Evas_Object *icon,
+					const char *path, int size,
+					const char *placeholder);
+/* drops the pending async load of the icon, if any */
+void quickpanel_icon_cache_cancel(Evas_Object *icon);
+
+/* drop least recently used images until at most bytes are kept */
+void quickpanel_icon_cache_trim(int bytes);
+
+void quickpanel_icon_cache_get_stats(qp_icon_cache_stats *stats);
+
+#endif /* __QP_ICON_CACHE_H__ */
@@ -35,6 +35,8 @@ static int quickpanel_idletxt_init(void *data);
 static int quickpanel_idletxt_fini(void *data);
 static int quickpanel_idletxt_suspend(void *data);
 static int quickpanel_idletxt_resume(void *data);
+static void quickpanel_idletxt_visibility_changed(void *data,
+					qp_visibility_e state);
 
 QP_Module idletxt = {
 	.name = "idletxt",
@@ -42,9 +44,13 @@ QP_Module idletxt = {
 	.fini = quickpanel_idletxt_fini,
 	.suspend = quickpanel_idletxt_suspend,
 	.resume = quickpanel_idletxt_resume,
-	.lang_changed = NULL
+	.lang_changed = NULL,
+	.visibility_changed = quickpanel_idletxt_visibility_changed,
 };
 
+/* texts changed while the panel was closed */
+static int g_idletxt_dirty;
+
 static Evas_Object *_quickpanel_idletxt_create_label(Evas_Object * parent,
 						     char *txt)
 {
@@ -268,6 +274,8 @@ static void quickpanel_idletxt_update(void *data)
 
 	retif(!ad->ly, , "layout is NULL!");
 
+	g_idletxt_dirty = 0;
+
 	spn = elm_object_part_content_get(ad->ly, QP_SPN_BASE_PART);
 	retif(!spn, , "spn layout is NULL!");
 
@@ -296,6 +304,16 @@ static void quickpanel_idletxt_update(void *data)
 
 static void quickpanel_idletxt_changed_cb(keynode_t *node, void *data)
 {
+	struct appdata *ad = data;
+
+	retif(!ad, , "Invalid parameter!");
+
+	/* labels are rebuilt when the panel opens */
+	if (!QP_IS_OPENED(ad)) {
+		g_idletxt_dirty = 1;
+		return;
+	}
+
 	quickpanel_idletxt_update(data);
 }
 
@@ -440,3 +458,10 @@ static int quickpanel_idletxt_resume(void *data)
 {
 	return QP_OK;
 }
+
+static void quickpanel_idletxt_visibility_changed(void *data,
+					qp_visibility_e state)
+{
+	if (state == QP_VISIBILITY_OPENING && g_idletxt_dirty)
+		quickpanel_idletxt_update(data);
+}
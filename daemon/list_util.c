@@ -16,15 +16,55 @@
 
 #include <Elementary.h>
 #include <stdlib.h>
+#include <string.h>
+#include <glib.h>
 
 #include "common.h"
+#include "mempool.h"
 #include "list_util.h"
+#include "quickpanel_theme_def.h"
+
+/* item data kept for reuse across list rebuilds */
+#define QP_ITEM_POOL_MAX	128
+/* gap left between ranks of items placed by position */
+#define QP_ITEM_RANK_STEP	(1 << 16)
 
 struct _qp_item_data {
 	qp_item_type_e type;
 	void *data;
+	/* item style the height is measured from */
+	const char *style;
+	int height;
+	/* height is set by the owner of the item */
+	int variable;
+	/* height is summed up in g_qp_type_height */
+	int counted;
+	/* genlist item and neighbours in the type section */
+	Elm_Object_Item *it;
+	qp_item_data *prev;
+	qp_item_data *next;
+	int linked;
+	/* next item of the section indexed under the same data */
+	qp_item_data *dup_next;
+	/* order in the type section, ascending */
+	long long rank;
+	/* rank set by the owner, otherwise taken from the neighbours */
+	int ranked;
+	/* position in the rank order of the section */
+	GSequenceIter *seq;
 };
 
+typedef struct _qp_item_anchor {
+	qp_item_data *first;
+	qp_item_data *last;
+	/* user data -> latest linked qid holding it */
+	GHashTable *index;
+	/* items of the section sorted by rank, which is the list order */
+	GSequence *order;
+} qp_item_anchor;
+
+static qp_mempool *g_qp_item_pool;
+
 static qp_item_count g_qp_item_count = {
 	.group = 0,
 	.ongoing = 0,
@@ -32,11 +72,27 @@ static qp_item_count g_qp_item_count = {
 	.minicontrol = 0,
 };
 
+/* "style:scale" -> measured height */
+static GHashTable *g_qp_height_cache;
+static double g_qp_scale = 1.0;
+static int g_qp_type_height[QP_ITEM_TYPE_MAX];
+/* first and last items of each type section, linked in list order */
+static qp_item_anchor g_qp_anchor[QP_ITEM_TYPE_MAX];
+/* items deleted in a batch, counted once when it ends */
+static int g_qp_del_batch;
+static int g_qp_del_pending[QP_ITEM_TYPE_MAX];
+/* item being deleted, reset once its del callback released it */
+static qp_item_data *g_qp_del_current;
+
 qp_item_data *quickpanel_list_util_item_new(qp_item_type_e type, void *data)
 {
 	qp_item_data *qid = NULL;
 
-	qid = malloc(sizeof(struct _qp_item_data));
+	if (!g_qp_item_pool)
+		g_qp_item_pool = quickpanel_mempool_new("qp_item_data",
+				sizeof(struct _qp_item_data), QP_ITEM_POOL_MAX);
+
+	qid = quickpanel_mempool_alloc(g_qp_item_pool);
 	if (!qid) {
 		ERR("fail to alloc qid");
 		return NULL;
@@ -44,10 +100,40 @@ qp_item_data *quickpanel_list_util_item_new(qp_item_type_e type, void *data)
 
 	qid->type = type;
 	qid->data = data;
+	qid->style = NULL;
+	qid->height = 0;
+	qid->variable = 0;
+	qid->counted = 0;
+	qid->it = NULL;
+	qid->prev = NULL;
+	qid->next = NULL;
+	qid->linked = 0;
+	qid->dup_next = NULL;
+	qid->rank = 0;
+	qid->ranked = 0;
+	qid->seq = NULL;
 
 	return qid;
 }
 
+void quickpanel_list_util_item_set_rank(qp_item_data *qid, long long rank)
+{
+	retif(qid == NULL, , "qid is NULL");
+	retif(qid->linked, , "item is already on the list");
+
+	qid->rank = rank;
+	qid->ranked = 1;
+}
+
+void quickpanel_list_util_item_free(qp_item_data *qid)
+{
+	if (!qid)
+		return;
+
+	quickpanel_list_util_del_count(qid);
+	quickpanel_mempool_free(g_qp_item_pool, qid);
+}
+
 void *quickpanel_list_util_item_get_data(qp_item_data *qid)
 {
 	void *user_data = NULL;
@@ -60,6 +146,13 @@ void *quickpanel_list_util_item_get_data(qp_item_data *qid)
 	return user_data;
 }
 
+qp_item_type_e quickpanel_list_util_item_get_type(qp_item_data *qid)
+{
+	retif(!qid, QP_ITEM_TYPE_SETTING, "qid is NULL");
+
+	return qid->type;
+}
+
 int quickpanel_list_util_item_compare(const void *data1, const void *data2)
 {
 	int diff = 0;
@@ -91,83 +184,331 @@ int quickpanel_list_util_item_compare(const void *data1, const void *data2)
 		return 1;
 	}
 
-	/* elm_genlist sort is not working as i expected */
-	if (qid1->type == qid2->type)
-		return 1;
+	if (qid1->type != qid2->type) {
+		diff = qid1->type - qid2->type;
+		return diff;
+	}
+
+	if (qid1->rank == qid2->rank)
+		return 0;
 
-	diff = qid1->type - qid2->type;
-	return diff;
+	return (qid1->rank < qid2->rank) ? -1 : 1;
 }
 
-void quickpanel_list_util_item_del_by_type(Evas_Object *list,
-				const Elm_Object_Item *refer_item,
-				qp_item_type_e type)
+static qp_item_anchor *__anchor_get(qp_item_type_e type)
 {
-	const Elm_Object_Item *start_item = NULL;
+	if (type < 0 || type >= QP_ITEM_TYPE_MAX)
+		return NULL;
 
-	if (!list)
+	return &g_qp_anchor[type];
+}
+
+static void __index_add(qp_item_anchor *anchor, qp_item_data *qid)
+{
+	if (!qid->data)
 		return;
 
-	if (refer_item)
-		start_item = refer_item;
-	else
-		start_item = elm_genlist_first_item_get(list);
+	if (!anchor->index)
+		anchor->index = g_hash_table_new(g_direct_hash, g_direct_equal);
 
-	while (start_item) {
-		qp_item_data *qid = NULL;
-		const Elm_Object_Item *next = NULL;
+	qid->dup_next = g_hash_table_lookup(anchor->index, qid->data);
+	g_hash_table_insert(anchor->index, qid->data, qid);
+}
 
-		next = elm_genlist_item_next_get(start_item);
-		qid = elm_object_item_data_get(start_item);
-		if (!qid) {
-			ERR("fail to get qid, continue loop");
-			continue;
-		}
+static void __index_remove(qp_item_anchor *anchor, qp_item_data *qid)
+{
+	qp_item_data *head = NULL;
+	qp_item_data *dup = NULL;
 
-		if (qid->type > type)
-			break;
-		else if (qid->type == type)
-			elm_object_item_del((Elm_Object_Item *)start_item);
+	if (!qid->data || !anchor->index)
+		return;
 
-		start_item = next;
+	head = g_hash_table_lookup(anchor->index, qid->data);
+	if (head == qid) {
+		if (qid->dup_next)
+			g_hash_table_insert(anchor->index, qid->data,
+					qid->dup_next);
+		else
+			g_hash_table_remove(anchor->index, qid->data);
+	} else {
+		for (dup = head; dup && dup->dup_next != qid;
+				dup = dup->dup_next)
+			;
+		if (dup)
+			dup->dup_next = qid->dup_next;
 	}
 
-	return;
+	qid->dup_next = NULL;
 }
 
-void quickpanel_list_util_item_update_by_type(Evas_Object *list,
-				Elm_Object_Item *refer_item,
-				qp_item_type_e type)
+static gint __rank_compare(gconstpointer data1, gconstpointer data2,
+			gpointer user_data)
 {
-	Elm_Object_Item *start_item = NULL;
+	const qp_item_data *qid1 = data1;
+	const qp_item_data *qid2 = data2;
 
-	if (!list)
+	if (qid1->rank == qid2->rank)
+		return 0;
+
+	return (qid1->rank < qid2->rank) ? -1 : 1;
+}
+
+/* rank between the neighbours of qid, spreading the section if needed */
+static void __rank_derive(qp_item_anchor *anchor, qp_item_data *qid)
+{
+	qp_item_data *prev = qid->prev;
+	qp_item_data *next = qid->next;
+	qp_item_data *cur = NULL;
+	long long rank = 0;
+
+	if (prev && next && next->rank - prev->rank < 2) {
+		DBG("no rank left after %lld, spread %d items", prev->rank,
+				g_sequence_get_length(anchor->order));
+
+		/* the order does not change, neither does the sequence */
+		for (cur = anchor->first; cur; cur = cur->next) {
+			cur->rank = rank;
+			rank += QP_ITEM_RANK_STEP;
+		}
+	}
+
+	if (prev && next)
+		qid->rank = prev->rank + (next->rank - prev->rank) / 2;
+	else if (prev)
+		qid->rank = prev->rank + QP_ITEM_RANK_STEP;
+	else if (next)
+		qid->rank = next->rank - QP_ITEM_RANK_STEP;
+	else
+		qid->rank = 0;
+}
+
+/* links qid after prev in its section, at the head if prev is NULL */
+static void __item_link(qp_item_data *qid, Elm_Object_Item *it,
+			qp_item_data *prev)
+{
+	qp_item_anchor *anchor = __anchor_get(qid->type);
+
+	qid->it = it;
+	if (!anchor || qid->linked)
 		return;
 
-	if (refer_item)
-		start_item = refer_item;
+	if (prev && (prev->type != qid->type || !prev->linked))
+		prev = NULL;
+
+	qid->prev = prev;
+	qid->next = prev ? prev->next : anchor->first;
+
+	if (qid->next)
+		qid->next->prev = qid;
 	else
-		start_item = elm_genlist_first_item_get(list);
+		anchor->last = qid;
+
+	if (prev)
+		prev->next = qid;
+	else
+		anchor->first = qid;
+
+	if (!anchor->order)
+		anchor->order = g_sequence_new(NULL);
+
+	if (!qid->ranked)
+		__rank_derive(anchor, qid);
+
+	qid->seq = g_sequence_insert_before(qid->next ? qid->next->seq :
+			g_sequence_get_end_iter(anchor->order), qid);
+
+	__index_add(anchor, qid);
+	qid->linked = 1;
+}
+
+static void __item_unlink(qp_item_data *qid)
+{
+	qp_item_anchor *anchor = __anchor_get(qid->type);
+
+	if (!anchor || !qid->linked)
+		return;
+
+	if (qid->prev)
+		qid->prev->next = qid->next;
+	else
+		anchor->first = qid->next;
+
+	if (qid->next)
+		qid->next->prev = qid->prev;
+	else
+		anchor->last = qid->prev;
+
+	__index_remove(anchor, qid);
+
+	if (qid->seq)
+		g_sequence_remove(qid->seq);
+
+	qid->seq = NULL;
+	qid->prev = NULL;
+	qid->next = NULL;
+	qid->it = NULL;
+	qid->linked = 0;
+}
+
+/* section item to start from, refer_item if it is in the section */
+static qp_item_data *__section_start(const Elm_Object_Item *refer_item,
+				qp_item_type_e type)
+{
+	qp_item_anchor *anchor = __anchor_get(type);
+	qp_item_data *qid = NULL;
+
+	if (!anchor)
+		return NULL;
+
+	if (refer_item) {
+		qid = elm_object_item_data_get(refer_item);
+		if (qid && qid->linked && qid->type == type)
+			return qid;
+		/* the section is before the reference item */
+		if (qid && qid->type > type)
+			return NULL;
+	}
+
+	return anchor->first;
+}
+
+Elm_Object_Item *quickpanel_list_util_get_first_item(qp_item_type_e type)
+{
+	qp_item_anchor *anchor = __anchor_get(type);
+
+	if (!anchor || !anchor->first)
+		return NULL;
+
+	return anchor->first->it;
+}
 
-	while (start_item) {
-		qp_item_data *qid = NULL;
-		Elm_Object_Item *next = NULL;
+Elm_Object_Item *quickpanel_list_util_get_last_item(qp_item_type_e type)
+{
+	qp_item_anchor *anchor = __anchor_get(type);
+
+	if (!anchor || !anchor->last)
+		return NULL;
+
+	return anchor->last->it;
+}
 
-		next = elm_genlist_item_next_get(start_item);
-		qid = elm_object_item_data_get(start_item);
-		if (!qid) {
-			ERR("fail to get qid, continue loop");
+static void __del_count(qp_item_type_e type, int n);
+static void __del_count_log(qp_item_type_e type);
+
+static void __item_del_batch_begin(void)
+{
+	if (g_qp_del_batch++ == 0)
+		memset(g_qp_del_pending, 0x00, sizeof(g_qp_del_pending));
+}
+
+static int __item_del_batch_end(void)
+{
+	int removed = 0;
+	int type = 0;
+
+	if (--g_qp_del_batch > 0)
+		return 0;
+
+	for (type = 0; type < QP_ITEM_TYPE_MAX; type++) {
+		if (g_qp_del_pending[type] <= 0)
 			continue;
-		}
 
-		if (qid->type > type)
-			break;
-		else if (qid->type == type) {
-			elm_genlist_item_fields_update(start_item, "*", ELM_GENLIST_ITEM_FIELD_ALL);
+		__del_count(type, g_qp_del_pending[type]);
+		removed += g_qp_del_pending[type];
+		g_qp_del_pending[type] = 0;
+	}
+
+	return removed;
+}
+
+/* deletes the items from qid to the end of its section */
+static void __item_del_section(qp_item_data *qid)
+{
+	qp_item_data *next = NULL;
+
+	while (qid) {
+		next = qid->next;
+
+		/* del callback of the item unlinks and frees qid */
+		g_qp_del_current = qid;
+		elm_object_item_del(qid->it);
+
+		/*
+		 * not released, the owner has no del callback or genlist
+		 * defers it while the item is walked, keep sections sane
+		 */
+		if (g_qp_del_current == qid) {
+			ERR("item[%p] is not released by its del callback", qid);
+			__item_unlink(qid);
 		}
+		g_qp_del_current = NULL;
+
+		qid = next;
+	}
+}
+
+void quickpanel_list_util_item_del_by_type(Evas_Object *list,
+				const Elm_Object_Item *refer_item,
+				qp_item_type_e type)
+{
+	qp_item_data *qid = NULL;
+
+	if (!list)
+		return;
+
+	qid = __section_start(refer_item, type);
+	if (!qid)
+		return;
 
-		start_item = next;
+	__item_del_batch_begin();
+	__item_del_section(qid);
+	__item_del_batch_end();
+	__del_count_log(type);
+
+	return;
+}
+
+int quickpanel_list_util_item_del_range(Evas_Object *list,
+				qp_item_type_e first, qp_item_type_e last)
+{
+	qp_item_anchor *anchor = NULL;
+	double start = 0.0;
+	int removed = 0;
+	int type = 0;
+
+	retif(list == NULL, 0, "list is NULL");
+	retif(first < 0 || last >= QP_ITEM_TYPE_MAX || first > last, 0,
+			"invalid range %d-%d", first, last);
+
+	start = ecore_time_get();
+
+	__item_del_batch_begin();
+	for (type = first; type <= last; type++) {
+		anchor = __anchor_get(type);
+		if (anchor)
+			__item_del_section(anchor->first);
 	}
+	removed = __item_del_batch_end();
+
+	DBG("type %d-%d, %d items deleted in %lf sec", first, last,
+			removed, ecore_time_get() - start);
+	__del_count_log(last);
+
+	return removed;
+}
+
+void quickpanel_list_util_item_update_by_type(Evas_Object *list,
+				Elm_Object_Item *refer_item,
+				qp_item_type_e type)
+{
+	qp_item_data *qid = NULL;
+
+	if (!list)
+		return;
+
+	for (qid = __section_start(refer_item, type); qid; qid = qid->next)
+		elm_genlist_item_fields_update(qid->it, "*",
+				ELM_GENLIST_ITEM_FIELD_ALL);
 
 	return;
 }
@@ -177,74 +518,183 @@ Elm_Object_Item *quickpanel_list_util_find_item_by_type(Evas_Object *list,
 				Elm_Object_Item *refer_item,
 				qp_item_type_e type)
 {
-	Elm_Object_Item *start_item = NULL;
-	Elm_Object_Item *found = NULL;
+	qp_item_anchor *anchor = __anchor_get(type);
+	qp_item_data *qid = NULL;
 
-	if (!list)
+	if (!list || !anchor || !anchor->index)
 		return NULL;
 
-	if (refer_item)
-		start_item = refer_item;
-	else
-		start_item = elm_genlist_first_item_get(list);
+	qid = g_hash_table_lookup(anchor->index, data);
 
-	while (start_item) {
-		qp_item_data *qid = NULL;
-		Elm_Object_Item *next = NULL;
-		void *user_data = NULL;
+	return qid ? qid->it : NULL;
+}
 
-		next = elm_genlist_item_next_get(start_item);
-		qid = elm_object_item_data_get(start_item);
-		if (!qid) {
-			ERR("fail to get qid, continue loop");
-			continue;
-		}
+/* heights the item styles were designed with, if the theme can not tell */
+static const struct {
+	const char *style;
+	int height;
+} g_qp_style_fallback[] = {
+	{ "notification_item", QP_THEME_LIST_ITEM_NOTI_HEIGHT },
+	{ "notification_ongoing_item", QP_THEME_LIST_ITEM_ONGOING_HEIGHT },
+	{ "qp_group_title", QP_THEME_LIST_ITEM_GROUP_HEIGHT },
+};
 
-		if (qid->type > type)
-			break;
-		else if (qid->type == type) {
-			user_data = quickpanel_list_util_item_get_data(qid);
-			if (user_data == data) {
-				found = start_item;
-				break;
-			}
-		}
+static int __style_height_fallback(const char *style)
+{
+	int i = 0;
 
-		start_item = next;
+	for (i = 0; i < (int)(sizeof(g_qp_style_fallback)
+			/ sizeof(g_qp_style_fallback[0])); i++) {
+		if (!strcmp(g_qp_style_fallback[i].style, style))
+			return g_qp_style_fallback[i].height * g_qp_scale;
 	}
 
-	return found;
+	return 0;
 }
 
-static int __item_compare(const void *data1, const void *data2)
+static int __style_height_load(Evas_Object *list, const char *file,
+				const char *group)
 {
-	int diff = 0;
-	const Elm_Object_Item *it1 = data1;
-	const qp_item_data *qid1 = NULL;
-	const qp_item_data *qid2 = data2;
+	Evas_Object *edje = NULL;
+	Evas_Coord h = 0;
 
-	if (!data1) {
-		INFO("data1 is NULL");
-		return -1;
-	}
+	edje = edje_object_add(evas_object_evas_get(list));
+	retif(edje == NULL, 0, "fail to add edje");
 
-	if (!data2) {
-		INFO("data2 is NULL");
-		return 1;
-	}
+	if (edje_object_file_set(edje, file, group)) {
+		edje_object_scale_set(edje, g_qp_scale);
+		edje_object_size_min_calc(edje, NULL, &h);
+	} else
+		ERR("fail to load %s", group);
 
-	qid1 = elm_object_item_data_get(it1);
+	evas_object_del(edje);
 
-	if (!qid1) {
-		INFO("qid1 is NULL");
-		return -1;
+	return h;
+}
+
+static int __style_height_measure(Evas_Object *list, const char *style)
+{
+	const char *file = NULL;
+	const char *list_style = NULL;
+	char group[256] = {0, };
+	int h = 0;
+
+	list_style = elm_object_style_get(list);
+	snprintf(group, sizeof(group), "elm/genlist/item/%s/%s", style,
+			list_style ? list_style : "default");
+
+	file = elm_theme_group_path_find(NULL, group);
+	if (file)
+		h = __style_height_load(list, file, group);
+	else
+		ERR("no theme for %s", group);
+
+	DBG("%s height[%d] scale[%lf]", style, h, g_qp_scale);
+
+	if (h <= 0) {
+		h = __style_height_fallback(style);
+		WARN("%s is not measured, fallback height[%d]", style, h);
 	}
 
-	diff = qid1->type - qid2->type;
+	return h;
+}
+
+static void __add_count(qp_item_data *qid);
+
+static void __item_height_prepare(Evas_Object *list,
+				const Elm_Genlist_Item_Class *itc,
+				qp_item_data *qid)
+{
+	if (qid->variable)
+		return;
+
+	qid->style = itc->item_style;
+	qid->height = quickpanel_list_util_get_style_height(list, qid->style);
+}
+
+static Elm_Object_Item *__item_sort_insert(Evas_Object *list,
+					const Elm_Genlist_Item_Class *itc,
+					const void *item_data,
+					Elm_Object_Item *parent,
+					Elm_Genlist_Item_Type type,
+					Evas_Smart_Cb func,
+					const void *func_data)
+{
+	qp_item_data *qid = (qp_item_data *)item_data;
+	qp_item_anchor *anchor = NULL;
+	qp_item_data *before = NULL;
+	qp_item_data *prev = NULL;
+	GSequenceIter *pos = NULL;
+	Elm_Object_Item *it = NULL;
+	int t = 0;
+
+	__item_height_prepare(list, itc, qid);
+
+	anchor = __anchor_get(qid->type);
+	retif(anchor == NULL, NULL, "invalid type %d", qid->type);
+
+	/* unranked items go to the head of the section, the newest first */
+	if (qid->ranked && anchor->order) {
+		pos = g_sequence_search(anchor->order, qid, __rank_compare,
+				NULL);
+		if (!g_sequence_iter_is_end(pos))
+			before = g_sequence_get(pos);
+		if (!g_sequence_iter_is_begin(pos))
+			prev = g_sequence_get(g_sequence_iter_prev(pos));
+	} else
+		before = anchor->first;
+
+	/* empty section, before the first item of a later type */
+	for (t = qid->type + 1; !before && !prev && t < QP_ITEM_TYPE_MAX; t++)
+		before = g_qp_anchor[t].first;
+
+	if (before)
+		it = elm_genlist_item_insert_before(list, itc, item_data,
+				parent, before->it, type, func, func_data);
+	else if (prev)
+		it = elm_genlist_item_insert_after(list, itc, item_data,
+				parent, prev->it, type, func, func_data);
+	else
+		it = elm_genlist_item_append(list, itc, item_data, parent,
+				type, func, func_data);
+
+	if (it)
+		__item_link(qid, it, prev);
 
-	return diff;
+	return it;
 }
 
+static Elm_Object_Item *__item_insert_after(Evas_Object *list,
+					const Elm_Genlist_Item_Class *itc,
+					const void *item_data,
+					Elm_Object_Item *parent,
+					Elm_Object_Item *after,
+					Elm_Genlist_Item_Type type,
+					Evas_Smart_Cb func,
+					const void *func_data)
+{
+	Elm_Object_Item *it = NULL;
+
+	/* without a reference item, fall back to the head of the type section */
+	if (!after)
+		return __item_sort_insert(list, itc, item_data, parent,
+				type, func, func_data);
+
+	__item_height_prepare(list, itc, (qp_item_data *)item_data);
+
+	/* the position given wins over a rank */
+	((qp_item_data *)item_data)->ranked = 0;
+
+	it = elm_genlist_item_insert_after(list, itc, item_data, parent,
+			after, type, func, func_data);
+
+	/* an item of another type before it makes it the head of the section */
+	if (it)
+		__item_link((qp_item_data *)item_data, it,
+				elm_object_item_data_get(after));
+
+	return it;
+}
 
 Elm_Object_Item *quickpanel_list_util_sort_insert(Evas_Object *list,
 					const Elm_Genlist_Item_Class *itc,
@@ -255,26 +705,13 @@ Elm_Object_Item *quickpanel_list_util_sort_insert(Evas_Object *list,
 					const void *func_data)
 {
 	Elm_Object_Item *it = NULL;
-	Elm_Object_Item *first = NULL;
 
 	retif(!list, NULL, "list is NULL");
 	retif(!itc, NULL, "itc is NULL");
 	retif(!item_data, NULL, "item_data is NULL");
 
-	first = elm_genlist_first_item_get(list);
-	while (first) {
-		if (__item_compare(first, item_data) >= 0)
-			break;
-
-		first = elm_genlist_item_next_get(first);
-	}
-
-	if (!first)
-		it = elm_genlist_item_append(list, itc, item_data, parent,
-				type, func, func_data);
-	else
-		it = elm_genlist_item_insert_before(list, itc, item_data,
-				parent, first, type, func, func_data);
+	it = __item_sort_insert(list, itc, item_data, parent, type,
+			func, func_data);
 
 	if (it != NULL) {
 		quickpanel_list_util_add_count((qp_item_data *)item_data);
@@ -283,15 +720,56 @@ Elm_Object_Item *quickpanel_list_util_sort_insert(Evas_Object *list,
 	return it;
 }
 
+int quickpanel_list_util_bulk_insert(Evas_Object *list,
+				Elm_Object_Item *parent,
+				Elm_Object_Item *after,
+				qp_item_entry *entries, int count)
+{
+	Elm_Object_Item *prev = after;
+	double start = 0.0;
+	int inserted = 0;
+	int i = 0;
+
+	retif(!list, 0, "list is NULL");
+	retif(!entries || count <= 0, 0, "no entries");
+
+	start = ecore_time_get();
+
+	/* only the first entry looks up its place, the others follow it */
+	for (i = 0; i < count; i++) {
+		entries[i].it = NULL;
+
+		if (!entries[i].itc || !entries[i].qid)
+			continue;
+
+		entries[i].it = __item_insert_after(list, entries[i].itc,
+				entries[i].qid, parent, prev, entries[i].type,
+				entries[i].func, entries[i].func_data);
+		if (!entries[i].it)
+			continue;
+
+		__add_count(entries[i].qid);
+		prev = entries[i].it;
+		inserted++;
+	}
+
+	DBG("%d/%d items inserted in %lf sec\nnum_ongoing:%d, num_group:%d, num_noti:%d, num_minicontrol:%d"
+			, inserted, count, ecore_time_get() - start
+			, g_qp_item_count.ongoing
+			, g_qp_item_count.group
+			, g_qp_item_count.noti
+			, g_qp_item_count.minicontrol);
+
+	return inserted;
+}
+
 qp_item_count *quickpanel_list_util_get_item_count(void)
 {
 	return &g_qp_item_count;
 }
 
-void quickpanel_list_util_add_count(qp_item_data *qid)
+static void __add_count(qp_item_data *qid)
 {
-	retif(qid == NULL, , "qid is NULL");
-
 	switch(qid->type)
 	{
 		case  QP_ITEM_TYPE_ONGOING_NOTI:
@@ -308,8 +786,22 @@ void quickpanel_list_util_add_count(qp_item_data *qid)
 		case  QP_ITEM_TYPE_MINICTRL_LOW:
 			g_qp_item_count.minicontrol++;
 			break;
+		default:
+			break;
 	}
 
+	if (!qid->counted && qid->type < QP_ITEM_TYPE_MAX) {
+		g_qp_type_height[qid->type] += qid->height;
+		qid->counted = 1;
+	}
+}
+
+void quickpanel_list_util_add_count(qp_item_data *qid)
+{
+	retif(qid == NULL, , "qid is NULL");
+
+	__add_count(qid);
+
 	DBG("(type:%d)\nnum_ongoing:%d, num_group:%d, num_noti:%d, num_minicontrol:%d"
 			, qid->type
 			, g_qp_item_count.ongoing
@@ -318,33 +810,31 @@ void quickpanel_list_util_add_count(qp_item_data *qid)
 			, g_qp_item_count.minicontrol);
 }
 
-void quickpanel_list_util_del_count(qp_item_data *qid)
-{
-	retif(qid == NULL, , "qid is NULL");
-
-	quickpanel_list_util_del_count_by_itemtype(qid->type);
-}
-
-void quickpanel_list_util_del_count_by_itemtype(qp_item_type_e type)
+static void __del_count(qp_item_type_e type, int n)
 {
 	switch(type)
 	{
 		case  QP_ITEM_TYPE_ONGOING_NOTI:
-			g_qp_item_count.ongoing = (g_qp_item_count.ongoing <= 0) ? 0 : g_qp_item_count.ongoing - 1;
+			g_qp_item_count.ongoing = (g_qp_item_count.ongoing <= n) ? 0 : g_qp_item_count.ongoing - n;
 			break;
 		case  QP_ITEM_TYPE_NOTI_GROUP:
-			g_qp_item_count.group = (g_qp_item_count.group <= 0) ? 0 : g_qp_item_count.group - 1;
+			g_qp_item_count.group = (g_qp_item_count.group <= n) ? 0 : g_qp_item_count.group - n;
 			break;
 		case  QP_ITEM_TYPE_NOTI:
-			g_qp_item_count.noti = (g_qp_item_count.noti <= 0) ? 0 : g_qp_item_count.noti - 1;
+			g_qp_item_count.noti = (g_qp_item_count.noti <= n) ? 0 : g_qp_item_count.noti - n;
 			break;
 		case  QP_ITEM_TYPE_MINICTRL_TOP:
 		case  QP_ITEM_TYPE_MINICTRL_MIDDLE:
 		case  QP_ITEM_TYPE_MINICTRL_LOW:
-			g_qp_item_count.minicontrol = (g_qp_item_count.minicontrol <= 0) ? 0 : g_qp_item_count.minicontrol - 1;
+			g_qp_item_count.minicontrol = (g_qp_item_count.minicontrol <= n) ? 0 : g_qp_item_count.minicontrol - n;
+			break;
+		default:
 			break;
 	}
+}
 
+static void __del_count_log(qp_item_type_e type)
+{
 	DBG("(type:%d)\nnum_ongoing:%d, num_group:%d, num_noti:%d, num_minicontrol:%d"
 			, type
 			, g_qp_item_count.ongoing
@@ -352,3 +842,109 @@ void quickpanel_list_util_del_count_by_itemtype(qp_item_type_e type)
 			, g_qp_item_count.noti
 			, g_qp_item_count.minicontrol);
 }
+
+void quickpanel_list_util_del_count(qp_item_data *qid)
+{
+	retif(qid == NULL, , "qid is NULL");
+
+	if (qid->counted && qid->type < QP_ITEM_TYPE_MAX) {
+		g_qp_type_height[qid->type] -= qid->height;
+		qid->counted = 0;
+	}
+
+	__item_unlink(qid);
+
+	if (qid == g_qp_del_current)
+		g_qp_del_current = NULL;
+
+	/* counted once when the whole batch is gone */
+	if (g_qp_del_batch && qid->type < QP_ITEM_TYPE_MAX) {
+		g_qp_del_pending[qid->type]++;
+		return;
+	}
+
+	__del_count(qid->type, 1);
+	__del_count_log(qid->type);
+}
+
+int quickpanel_list_util_get_style_height(Evas_Object *list,
+					const char *style)
+{
+	char *key = NULL;
+	gpointer value = NULL;
+	int height = 0;
+
+	retif(list == NULL, 0, "list is NULL");
+	retif(style == NULL, 0, "style is NULL");
+
+	if (!g_qp_height_cache)
+		g_qp_height_cache = g_hash_table_new_full(g_str_hash,
+				g_str_equal, g_free, NULL);
+
+	key = g_strdup_printf("%s:%.3lf", style, g_qp_scale);
+	retif(key == NULL, 0, "fail to alloc key");
+
+	if (g_hash_table_lookup_extended(g_qp_height_cache, key, NULL,
+			&value)) {
+		g_free(key);
+		return GPOINTER_TO_INT(value);
+	}
+
+	height = __style_height_measure(list, style);
+	/* no fallback either, not cached, the theme may show up later */
+	if (height <= 0) {
+		g_free(key);
+		return 0;
+	}
+
+	g_hash_table_insert(g_qp_height_cache, key, GINT_TO_POINTER(height));
+
+	return height;
+}
+
+void quickpanel_list_util_set_scale(Evas_Object *list, double scale)
+{
+	Elm_Object_Item *it = NULL;
+	qp_item_data *qid = NULL;
+
+	retif(list == NULL, , "list is NULL");
+
+	if (scale == g_qp_scale)
+		return;
+
+	INFO("scale %lf -> %lf", g_qp_scale, scale);
+	g_qp_scale = scale;
+
+	memset(g_qp_type_height, 0x00, sizeof(g_qp_type_height));
+
+	it = elm_genlist_first_item_get(list);
+	while (it) {
+		qid = elm_object_item_data_get(it);
+		if (qid && qid->counted && qid->type < QP_ITEM_TYPE_MAX) {
+			if (!qid->variable && qid->style)
+				qid->height = quickpanel_list_util_get_style_height(
+						list, qid->style);
+			g_qp_type_height[qid->type] += qid->height;
+		}
+
+		it = elm_genlist_item_next_get(it);
+	}
+}
+
+void quickpanel_list_util_item_set_height(qp_item_data *qid, int height)
+{
+	retif(qid == NULL, , "qid is NULL");
+
+	if (qid->counted && qid->type < QP_ITEM_TYPE_MAX)
+		g_qp_type_height[qid->type] += height - qid->height;
+
+	qid->height = height;
+	qid->variable = 1;
+}
+
+int quickpanel_list_util_get_height(qp_item_type_e type)
+{
+	retif(type < 0 || type >= QP_ITEM_TYPE_MAX, 0, "invalid type");
+
+	return g_qp_type_height[type];
+}
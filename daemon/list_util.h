@@ -28,9 +28,21 @@ typedef enum {
 	QP_ITEM_TYPE_MINICTRL_LOW,
 	QP_ITEM_TYPE_NOTI_GROUP,
 	QP_ITEM_TYPE_NOTI,
+	QP_ITEM_TYPE_MAX,
 } qp_item_type_e;
 
 typedef struct _qp_item_data qp_item_data;
+
+/* an item of quickpanel_list_util_bulk_insert() */
+typedef struct _qp_item_entry {
+	const Elm_Genlist_Item_Class *itc;
+	qp_item_data *qid;
+	Elm_Genlist_Item_Type type;
+	Evas_Smart_Cb func;
+	const void *func_data;
+	/* inserted item, NULL if it failed */
+	Elm_Object_Item *it;
+} qp_item_entry;
 typedef struct _qp_item_count {
 	int group;
 	int ongoing;
@@ -40,24 +52,53 @@ typedef struct _qp_item_count {
 
 
 qp_item_data *quickpanel_list_util_item_new(qp_item_type_e type, void *data);
+/*
+ * orders the item in its type section before it is sort inserted, lower
+ * ranks first, found by a binary search. items without a rank go to the
+ * head of the section and items bulk inserted after another one take a
+ * rank between their neighbours, which may spread the ranks of the
+ * section. owners ranking their items should not place them by position.
+ */
+void quickpanel_list_util_item_set_rank(qp_item_data *qid, long long rank);
+/* for item del callbacks, drops the item from counts and sections */
+void quickpanel_list_util_item_free(qp_item_data *qid);
 
 void *quickpanel_list_util_item_get_data(qp_item_data *qid);
 
+qp_item_type_e quickpanel_list_util_item_get_type(qp_item_data *qid);
+
 int quickpanel_list_util_item_compare(const void *data1, const void *data2);
 
 void quickpanel_list_util_item_del_by_type(Evas_Object *list,
 				const Elm_Object_Item *refer_item,
 				qp_item_type_e type);
 
+/*
+ * deletes every item from type first to type last at once, item counts
+ * are updated once. returns the number of items deleted.
+ * there is no genlist freeze around it, see bulk insert.
+ */
+int quickpanel_list_util_item_del_range(Evas_Object *list,
+				qp_item_type_e first, qp_item_type_e last);
+
 void quickpanel_list_util_item_update_by_type(Evas_Object *list,
 				Elm_Object_Item *refer_item,
 				qp_item_type_e type);
 
+/*
+ * item of the type holding data, looked up in the index of the section.
+ * if several items hold data, the latest linked one. refer_item is kept
+ * for compatibility, the lookup does not need it.
+ */
 Elm_Object_Item *quickpanel_list_util_find_item_by_type(Evas_Object *list,
 					void *data,
 					Elm_Object_Item *refer_item,
 					qp_item_type_e type);
 
+/* first and last items of the type section, NULL if it is empty */
+Elm_Object_Item *quickpanel_list_util_get_first_item(qp_item_type_e type);
+Elm_Object_Item *quickpanel_list_util_get_last_item(qp_item_type_e type);
+
 Elm_Object_Item *quickpanel_list_util_sort_insert(Evas_Object *list,
 					const Elm_Genlist_Item_Class *itc,
 					const void *item_data,
@@ -66,10 +107,33 @@ Elm_Object_Item *quickpanel_list_util_sort_insert(Evas_Object *list,
 					Evas_Smart_Cb func,
 					const void *func_data);
 
+/*
+ * inserts entries sorted by type after the after item, at the head of the
+ * section of the first entry if after is NULL. the list is walked at most
+ * once. returns the number of items inserted.
+ * elm_genlist has no freeze, it lays the batch out in its calc job once
+ * the caller returns to the main loop.
+ */
+int quickpanel_list_util_bulk_insert(Evas_Object *list,
+				Elm_Object_Item *parent,
+				Elm_Object_Item *after,
+				qp_item_entry *entries, int count);
+
 qp_item_count *quickpanel_list_util_get_item_count(void);
 void quickpanel_list_util_add_count(qp_item_data *qid);
 void quickpanel_list_util_del_count(qp_item_data *qid);
-void quickpanel_list_util_del_count_by_itemtype(qp_item_type_e type);
+
+/*
+ * item heights are measured once per item style and scale from the theme,
+ * items inserted to the list are summed up per type as they come and go
+ */
+int quickpanel_list_util_get_style_height(Evas_Object *list,
+					const char *style);
+/* re-measures the items of the list if the scale has changed */
+void quickpanel_list_util_set_scale(Evas_Object *list, double scale);
+/* variable height item, the style height is not used anymore */
+void quickpanel_list_util_item_set_height(qp_item_data *qid, int height);
+int quickpanel_list_util_get_height(qp_item_type_e type);
 
 #endif /* _QP_LIST_UTIL_DEF_ */
 
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <Eina.h>
+
+#include "common.h"
+#include "mempool.h"
+
+/* freed chunks are linked through their first bytes */
+typedef struct _qp_mempool_chunk {
+	struct _qp_mempool_chunk *next;
+} qp_mempool_chunk;
+
+struct _qp_mempool {
+	char *name;
+	size_t size;
+	int max_cached;
+	qp_mempool_chunk *free_list;
+	qp_mempool_stats stats;
+};
+
+static Eina_List *g_mempools;
+
+qp_mempool *quickpanel_mempool_new(const char *name, size_t size,
+				int max_cached)
+{
+	qp_mempool *pool = NULL;
+
+	retif(size == 0, NULL, "Invalid parameter!");
+
+	pool = calloc(1, sizeof(qp_mempool));
+	retif(pool == NULL, NULL, "fail to alloc pool");
+
+	pool->name = strdup(name ? name : "");
+	pool->size = (size < sizeof(qp_mempool_chunk)) ?
+			sizeof(qp_mempool_chunk) : size;
+	pool->max_cached = (max_cached > 0) ? max_cached : 0;
+
+	g_mempools = eina_list_append(g_mempools, pool);
+
+	return pool;
+}
+
+void quickpanel_mempool_destroy(qp_mempool *pool)
+{
+	retif(pool == NULL, , "Invalid parameter!");
+
+	quickpanel_mempool_trim(pool, 0);
+
+	INFO("%s hits[%u] mallocs[%u] frees[%u] drops[%u] in use[%d] peak[%d]",
+		pool->name, pool->stats.hits, pool->stats.mallocs,
+		pool->stats.frees, pool->stats.drops, pool->stats.in_use,
+		pool->stats.peak);
+
+	g_mempools = eina_list_remove(g_mempools, pool);
+
+	free(pool->name);
+	free(pool);
+}
+
+void *quickpanel_mempool_alloc(qp_mempool *pool)
+{
+	qp_mempool_chunk *chunk = NULL;
+
+	retif(pool == NULL, NULL, "Invalid parameter!");
+
+	if (pool->free_list) {
+		chunk = pool->free_list;
+		pool->free_list = chunk->next;
+		pool->stats.cached--;
+		pool->stats.hits++;
+	} else {
+		chunk = malloc(pool->size);
+		retif(chunk == NULL, NULL, "fail to alloc %s", pool->name);
+		pool->stats.mallocs++;
+	}
+
+	memset(chunk, 0x00, pool->size);
+
+	pool->stats.in_use++;
+	if (pool->stats.in_use > pool->stats.peak)
+		pool->stats.peak = pool->stats.in_use;
+
+	return chunk;
+}
+
+void quickpanel_mempool_free(qp_mempool *pool, void *ptr)
+{
+	qp_mempool_chunk *chunk = ptr;
+
+	if (!ptr)
+		return;
+
+	retif(pool == NULL, , "Invalid parameter!");
+
+	pool->stats.frees++;
+	pool->stats.in_use--;
+
+	if (pool->stats.cached >= pool->max_cached) {
+		free(chunk);
+		pool->stats.drops++;
+		return;
+	}
+
+	chunk->next = pool->free_list;
+	pool->free_list = chunk;
+	pool->stats.cached++;
+}
+
+void quickpanel_mempool_trim(qp_mempool *pool, int keep)
+{
+	qp_mempool_chunk *chunk = NULL;
+
+	retif(pool == NULL, , "Invalid parameter!");
+
+	while (pool->free_list && pool->stats.cached > keep) {
+		chunk = pool->free_list;
+		pool->free_list = chunk->next;
+		pool->stats.cached--;
+		free(chunk);
+	}
+}
+
+void quickpanel_mempool_trim_all(void)
+{
+	Eina_List *l = NULL;
+	qp_mempool *pool = NULL;
+
+	EINA_LIST_FOREACH(g_mempools, l, pool) {
+		INFO("%s hits[%u] mallocs[%u] in use[%d] peak[%d] cached[%d]",
+			pool->name, pool->stats.hits, pool->stats.mallocs,
+			pool->stats.in_use, pool->stats.peak,
+			pool->stats.cached);
+		quickpanel_mempool_trim(pool, 0);
+	}
+}
+
+void quickpanel_mempool_get_stats(qp_mempool *pool, qp_mempool_stats *stats)
+{
+	retif(pool == NULL, , "Invalid parameter!");
+	retif(stats == NULL, , "Invalid parameter!");
+
+	*stats = pool->stats;
+}
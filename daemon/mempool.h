@@ -0,0 +1,55 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QP_MEMPOOL_H__
+#define __QP_MEMPOOL_H__
+
+#include <stddef.h>
+
+typedef struct _qp_mempool qp_mempool;
+
+typedef struct _qp_mempool_stats {
+	/* allocations served from the free list and from the heap */
+	unsigned int hits;
+	unsigned int mallocs;
+	unsigned int frees;
+	/* freed over the free list size and given back to the heap */
+	unsigned int drops;
+	int in_use;
+	int peak;
+	int cached;
+} qp_mempool_stats;
+
+/*
+ * fixed size free list, at most max_cached freed chunks are kept for the
+ * next allocations
+ */
+qp_mempool *quickpanel_mempool_new(const char *name, size_t size,
+				int max_cached);
+/* chunks still in use are left to the heap */
+void quickpanel_mempool_destroy(qp_mempool *pool);
+
+/* zeroed chunk */
+void *quickpanel_mempool_alloc(qp_mempool *pool);
+void quickpanel_mempool_free(qp_mempool *pool, void *ptr);
+
+/* gives cached chunks back to the heap until at most keep are left */
+void quickpanel_mempool_trim(qp_mempool *pool, int keep);
+void quickpanel_mempool_trim_all(void);
+
+void quickpanel_mempool_get_stats(qp_mempool *pool, qp_mempool_stats *stats);
+
+#endif /* __QP_MEMPOOL_H__ */
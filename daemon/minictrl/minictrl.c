@@ -50,6 +50,8 @@ struct _viewer_item {
 };
 
 GHashTable *g_prov_table;
+/* the latest viewer ranks first in its section */
+static long long g_viewer_rank;
 
 static void _viewer_item_free(struct _viewer_item *item)
 {
@@ -132,8 +134,7 @@ static Eina_Bool _minictrl_gl_get_state(void *data, Evas_Object *obj,
 static void _minictrl_gl_del(void *data, Evas_Object *obj)
 {
 	if (data) {
-		quickpanel_list_util_del_count(data);
-		free(data);
+		quickpanel_list_util_item_free(data);
 	}
 
 	return;
@@ -245,6 +246,10 @@ static void _minictrl_add(const char *name, unsigned int width,
 		free(vit);
 		return;
 	}
+	/* providers size their viewers, the style does not tell the height */
+	quickpanel_list_util_item_set_height(qid, height);
+	quickpanel_list_util_item_set_rank(qid, --g_viewer_rank);
+
 	vit->name = strdup(name);
 	vit->width = width;
 	vit->height = height;
@@ -304,6 +309,8 @@ static void _minictrl_update(const char *name, unsigned int width,
 		evas_object_size_hint_min_set(found->viewer, width , height);
 
 	if (found->it) {
+		quickpanel_list_util_item_set_height(
+				elm_object_item_data_get(found->it), height);
 		elm_genlist_item_update(found->it);
 		quickpanel_ui_update_height(ad);
 	}
@@ -368,22 +375,9 @@ static int quickpanel_minictrl_fini(void *data)
 }
 
 
-static void _quickpanel_minictrl_hf_sum_height(gpointer key, gpointer value, gpointer data)
-{
-	struct _viewer_item *item = value;
-
-	if (item != NULL && data != NULL) {
-		*((unsigned int *)data) += item->height;
-	}
-}
-
 static int quickpanel_minictrl_get_height(void *data)
 {
-	unsigned int height_minictrl = 0;
-
-	if (g_prov_table != NULL) {
-		g_hash_table_foreach(g_prov_table, _quickpanel_minictrl_hf_sum_height, &height_minictrl);
-	}
-
-	return height_minictrl;
+	return quickpanel_list_util_get_height(QP_ITEM_TYPE_MINICTRL_TOP)
+		+ quickpanel_list_util_get_height(QP_ITEM_TYPE_MINICTRL_MIDDLE)
+		+ quickpanel_list_util_get_height(QP_ITEM_TYPE_MINICTRL_LOW);
 }
@@ -143,6 +143,28 @@ void lang_change_modules(void *data)
 	}
 }
 
+void region_change_modules(void *data)
+{
+	int i;
+	retif(data == NULL, , "Invalid parameter!");
+
+	for (i = 0; i < sizeof(modules) / sizeof(modules[0]); i++) {
+		if (modules[i]->region_changed)
+			modules[i]->region_changed(data);
+	}
+}
+
+void visibility_change_modules(void *data, qp_visibility_e state)
+{
+	int i;
+	retif(data == NULL, , "Invalid parameter!");
+
+	for (i = 0; i < sizeof(modules) / sizeof(modules[0]); i++) {
+		if (modules[i]->visibility_changed)
+			modules[i]->visibility_changed(data, state);
+	}
+}
+
 void refresh_modules(void *data)
 {
 	int i;
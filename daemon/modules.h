@@ -27,6 +27,8 @@ extern int resume_modules(void *data);
 extern int hib_enter_modules(void *data);
 extern int hib_leave_modules(void *data);
 extern void lang_change_modules(void *data);
+extern void region_change_modules(void *data);
+extern void visibility_change_modules(void *data, qp_visibility_e state);
 extern void refresh_modules(void *data);
 
 #endif /* __QP_MODULES_H__ */
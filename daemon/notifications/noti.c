@@ -18,6 +18,7 @@
 #include <appsvc.h>
 
 #include <time.h>
+#include <glib.h>
 #include <vconf.h>
 #include <appcore-common.h>
 #include <app_service.h>
@@ -34,18 +35,70 @@
 #include "quickpanel-ui.h"
 #include "common.h"
 #include "list_util.h"
-#include "quickpanel_theme_def.h"
+#include "noti_node.h"
+#include "noti.h"
+#include "noti_db.h"
+#include "noti_pool.h"
+#include "icon_cache.h"
 
 #ifndef VCONFKEY_QUICKPANEL_STARTED
 #define VCONFKEY_QUICKPANEL_STARTED "memory/private/"PACKAGE_NAME"/started"
 #endif /* VCONFKEY_QUICKPANEL_STARTED */
 
 #define QP_DEFAULT_ICON	ICONDIR"/quickpanel_icon_default.png"
-#define QP_NOTI_DAY_DEC	(24 * 60 * 60)
 
 #define QP_NOTI_ONGOING_DBUS_PATH	"/dbus/signal"
 #define QP_NOTI_ONGOING_DBUS_INTERFACE	"notification.ongoing"
 
+#define QP_NOTI_FIRST_PAGE_MIN	8
+
+/* thumbnails are decoded at most this large, before scaling */
+#define QP_NOTI_THUMBNAIL_SIZE	150
+
+/* quiet time before a closed panel reconciles its list */
+#define QP_NOTI_REBUILD_DELAY	3.0
+
+#define QP_NOTI_MAX_ITEMS	100
+#define QP_NOTI_MAX_PER_APP	10
+#define QP_NOTI_MORE_SUFFIX	":more"
+
+typedef struct _qp_noti_shown_item {
+	char *key;
+	/* NULL for the aggregate of an app's overflow */
+	notification_h noti;
+	int more;
+	char *label;
+	char *icon_path;
+	/* rank of the app, aggregates follow the order of their apps */
+	int order;
+} qp_noti_shown_item;
+
+typedef struct _qp_noti_more_ctx {
+	/* pkgname -> notifications of the app already shown */
+	GHashTable *per_app;
+	GPtrArray *more;
+} qp_noti_more_ctx;
+
+#define QP_NOTI_UPDATE_PROGRESS	(1 << 0)
+#define QP_NOTI_UPDATE_SIZE	(1 << 1)
+#define QP_NOTI_UPDATE_CONTENT	(1 << 2)
+
+enum {
+	QP_NOTI_PROGRESS_NONE = 0,
+	QP_NOTI_PROGRESS_DETERMINATE,
+	QP_NOTI_PROGRESS_PENDING,
+	QP_NOTI_PROGRESS_TEXT,
+};
+
+typedef struct _qp_noti_update_item {
+	unsigned int flags;
+	double progress;
+	double size;
+	char *content;
+	/* of the notification the values were sent for, kept state only */
+	time_t insert_time;
+} qp_noti_update_item;
+
 static int suspended;
 
 static notification_list_h g_notification_list;
@@ -58,15 +111,52 @@ static Elm_Genlist_Item_Class *g_itc;
 static Evas_Object *g_window;
 
 static Elm_Object_Item *noti_group;
-static Elm_Object_Item *ongoing_first;
-static Elm_Object_Item *noti_first;
+
+/* caps of the noti section, apps expanded by the user ignore the per app one */
+static int g_noti_max_items = QP_NOTI_MAX_ITEMS;
+static int g_noti_max_per_app = QP_NOTI_MAX_PER_APP;
+static GHashTable *g_noti_expanded;
+
+/* clear button of the group title, referenced like minictrl viewers */
+static Evas_Object *g_clear_button;
+
+/* count on the group title, follows the reconciled noti section */
+static int g_noti_group_count;
+
+/* time label state of _quickpanel_noti_get_time */
+static time_t g_time_today;
+static time_t g_time_yesterday;
+static time_t g_time_tomorrow;
+static int g_time_24hour;
+static Ecore_Timer *g_time_timer;
+
+/* date formatter of _quickpanel_noti_get_time */
+static UDateFormat *g_date_formatter;
+static const char *g_date_skeleton;
+
+/* list changes not reconciled yet, the panel was closed */
+static int g_list_dirty;
+static Ecore_Timer *g_rebuild_timer;
+static Ecore_Idler *g_rebuild_idler;
+
+/* pending DBus updates, flushed once per frame */
+static GHashTable *g_update_table;
+/* latest DBus values of every mirrored notification, the store lacks them */
+static GHashTable *g_update_state;
+static Ecore_Animator *g_update_animator;
+static qp_noti_update_stats g_update_stats;
+
+void _quickpanel_noti_update_notilist(struct appdata *ad);
 
 static int quickpanel_noti_init(void *data);
 static int quickpanel_noti_fini(void *data);
 static int quickpanel_noti_suspend(void *data);
 static int quickpanel_noti_resume(void *data);
 static void quickpanel_noti_lang_changed(void *data);
+static void quickpanel_noti_region_changed(void *data);
 static int quickpanel_noti_get_height(void *data);
+static void quickpanel_noti_visibility_changed(void *data,
+					qp_visibility_e state);
 
 QP_Module noti = {
 	.name = "noti",
@@ -75,6 +165,8 @@ QP_Module noti = {
 	.suspend = quickpanel_noti_suspend,
 	.resume = quickpanel_noti_resume,
 	.lang_changed = quickpanel_noti_lang_changed,
+	.region_changed = quickpanel_noti_region_changed,
+	.visibility_changed = quickpanel_noti_visibility_changed,
 	.hib_enter = NULL,
 	.hib_leave = NULL,
 	.refresh = NULL,
@@ -88,7 +180,7 @@ static void _quickpanel_noti_clear_clicked_cb(void *data, Evas_Object * obj,
 	notification_error_e noti_err = NOTIFICATION_ERROR_NONE;
 
 	noti_err =
-	    notification_get_count(NOTIFICATION_TYPE_NOTI, NULL,
+	    quickpanel_noti_db_get_count(NOTIFICATION_TYPE_NOTI, NULL,
 				   NOTIFICATION_GROUP_ID_NONE,
 				   NOTIFICATION_PRIV_ID_NONE, &count);
 
@@ -145,167 +237,308 @@ static char *_quickpanel_noti_get_progress(notification_h noti, char *buf,
 	return NULL;
 }
 
-static notification_h _quickpanel_noti_update_item_progress(const char *pkgname,
-							    int priv_id,
-							    double progress)
+static int _quickpanel_noti_progress_mode(notification_h noti)
 {
-	notification_h noti = NULL;
-	notification_list_h head = NULL;
-	char *noti_pkgname = NULL;
-	int noti_priv_id = 0;
-
-	if (g_notification_ongoing_list) {
-		head = notification_list_get_head(g_notification_ongoing_list);
-
-		while (head != NULL) {
-			noti = notification_list_get_data(head);
-			notification_get_pkgname(noti, &noti_pkgname);
-			notification_get_id(noti, NULL, &noti_priv_id);
-			if (!strcmp(noti_pkgname, pkgname)
-			    && priv_id == noti_priv_id) {
-				notification_set_progress(noti, progress);
-				return noti;
-			}
-			head = notification_list_get_next(head);
-		}
+	double size = 0.0;
+	double percentage = 0.0;
+
+	notification_get_size(noti, &size);
+	notification_get_progress(noti, &percentage);
+
+	if (percentage > 0 && percentage <= 1)
+		return QP_NOTI_PROGRESS_DETERMINATE;
+	else if (size > 0)
+		return QP_NOTI_PROGRESS_PENDING;
+	else if (percentage > 0)
+		return QP_NOTI_PROGRESS_TEXT;
+
+	return QP_NOTI_PROGRESS_NONE;
+}
+
+static void _quickpanel_noti_progress_del_cb(void *data, Evas *e,
+					Evas_Object *obj, void *event_info)
+{
+	noti_node_item *node = data;
+
+	if (node && node->progress == obj)
+		node->progress = NULL;
+}
+
+static void _quickpanel_noti_progress_unset(noti_node_item *node)
+{
+	if (!node || !node->progress)
+		return;
+
+	evas_object_event_callback_del_full(node->progress, EVAS_CALLBACK_DEL,
+			_quickpanel_noti_progress_del_cb, node);
+	node->progress = NULL;
+}
+
+static void _quickpanel_noti_progress_set(noti_node_item *node,
+					Evas_Object *progress)
+{
+	_quickpanel_noti_progress_unset(node);
+
+	node->progress = progress;
+	evas_object_event_callback_add(progress, EVAS_CALLBACK_DEL,
+			_quickpanel_noti_progress_del_cb, node);
+}
+
+/* pooled object bound to a content slot of the node */
+static Evas_Object *_quickpanel_noti_content_bind(Evas_Object **slot,
+					qp_noti_pool_type_e type)
+{
+	if (*slot && quickpanel_noti_pool_get_type(*slot) != type) {
+		quickpanel_icon_cache_cancel(*slot);
+		quickpanel_noti_pool_release(*slot);
+		*slot = NULL;
 	}
 
-	if (g_notification_list) {
-		head = notification_list_get_head(g_notification_list);
+	if (!*slot)
+		*slot = quickpanel_noti_pool_get(type);
 
-		while (head != NULL) {
-			noti = notification_list_get_data(head);
-			notification_get_pkgname(noti, &noti_pkgname);
-			notification_get_id(noti, NULL, &noti_priv_id);
-			if (!strcmp(noti_pkgname, pkgname)
-			    && priv_id == noti_priv_id) {
-				notification_set_progress(noti, progress);
-				return noti;
-			}
-			head = notification_list_get_next(head);
+	return *slot;
+}
+
+static void _quickpanel_noti_content_unbind(Evas_Object **slot)
+{
+	if (!*slot)
+		return;
+
+	/* a row scrolled away does not need its image anymore */
+	quickpanel_icon_cache_cancel(*slot);
+	quickpanel_noti_pool_release(*slot);
+	*slot = NULL;
+}
+
+/* view of the node is gone, its contents go back to the pool */
+static void _quickpanel_noti_contents_release(noti_node_item *node)
+{
+	Evas_Object *progress = NULL;
+
+	if (!node)
+		return;
+
+	progress = node->progress;
+	_quickpanel_noti_progress_unset(node);
+	if (progress)
+		quickpanel_noti_pool_release(progress);
+
+	_quickpanel_noti_content_unbind(&node->icon);
+	_quickpanel_noti_content_unbind(&node->thumbnail);
+}
+
+static void _quickpanel_noti_update_item_view(void *data,
+					noti_node_item *node,
+					unsigned int flags, int old_mode)
+{
+	struct appdata *ad = NULL;
+	notification_type_e type = NOTIFICATION_TYPE_NONE;
+	double percentage = 0.0;
+	int mode = QP_NOTI_PROGRESS_NONE;
+
+	retif(!data, , "data is NULL");
+	ad = data;
+
+	retif(!ad->list, , "ad->list is NULL");
+	retif(!node, , "node is NULL");
+
+	/* notification is not shown on the tray */
+	if (!node->view)
+		return;
+
+	notification_get_type(node->noti, &type);
+	mode = _quickpanel_noti_progress_mode(node->noti);
+
+	/* layout changes, let the item class rebuild its contents */
+	if (type != NOTIFICATION_TYPE_ONGOING || mode != old_mode
+	    || ((mode == QP_NOTI_PROGRESS_DETERMINATE
+		|| mode == QP_NOTI_PROGRESS_PENDING) && !node->progress)) {
+		elm_genlist_item_fields_update(node->view, "*",
+				ELM_GENLIST_ITEM_FIELD_ALL);
+		return;
+	}
+
+	if (flags & (QP_NOTI_UPDATE_PROGRESS | QP_NOTI_UPDATE_SIZE)) {
+		if (mode == QP_NOTI_PROGRESS_DETERMINATE) {
+			notification_get_progress(node->noti, &percentage);
+			elm_progressbar_value_set(node->progress, percentage);
 		}
+
+		elm_genlist_item_fields_update(node->view, "elm.text.time",
+				ELM_GENLIST_ITEM_FIELD_TEXT);
 	}
 
-	return NULL;
+	if (flags & QP_NOTI_UPDATE_CONTENT)
+		elm_genlist_item_fields_update(node->view, "elm.text.content*",
+				ELM_GENLIST_ITEM_FIELD_TEXT);
 }
 
-static notification_h _quickpanel_noti_update_item_size(const char *pkgname,
-							int priv_id,
-							double size)
+static void _quickpanel_noti_update_item_free(void *data)
 {
-	notification_h noti = NULL;
-	notification_list_h head = NULL;
-	char *noti_pkgname = NULL;
-	int noti_priv_id = 0;
-
-	if (g_notification_ongoing_list) {
-		head = notification_list_get_head(g_notification_ongoing_list);
-
-		while (head != NULL) {
-			noti = notification_list_get_data(head);
-			notification_get_pkgname(noti, &noti_pkgname);
-			notification_get_id(noti, NULL, &noti_priv_id);
-			if (!strcmp(noti_pkgname, pkgname)
-			    && priv_id == noti_priv_id) {
-				notification_set_size(noti, size);
-				return noti;
-			}
-			head = notification_list_get_next(head);
+	qp_noti_update_item *update = data;
+
+	if (!update)
+		return;
+
+	if (update->content)
+		free(update->content);
+
+	free(update);
+}
+
+static void _quickpanel_noti_update_apply(notification_h noti,
+					qp_noti_update_item *update)
+{
+	if (update->flags & QP_NOTI_UPDATE_PROGRESS)
+		notification_set_progress(noti, update->progress);
+
+	if (update->flags & QP_NOTI_UPDATE_SIZE)
+		notification_set_size(noti, update->size);
+
+	if (update->flags & QP_NOTI_UPDATE_CONTENT)
+		notification_set_text(noti,
+			NOTIFICATION_TEXT_TYPE_CONTENT,
+			update->content, NULL,
+			NOTIFICATION_VARIABLE_TYPE_NONE);
+}
+
+/* keeps the values for the lists the mirror reads later */
+static void _quickpanel_noti_update_keep(const char *key, notification_h noti,
+					qp_noti_update_item *update)
+{
+	qp_noti_update_item *state = NULL;
+	char *state_key = NULL;
+
+	state = g_hash_table_lookup(g_update_state, key);
+	if (!state) {
+		state = calloc(1, sizeof(qp_noti_update_item));
+		state_key = strdup(key);
+		if (!state || !state_key) {
+			ERR("fail to alloc update state");
+			free(state);
+			free(state_key);
+			return;
 		}
+		g_hash_table_insert(g_update_state, state_key, state);
 	}
 
-	if (g_notification_list) {
-		head = notification_list_get_head(g_notification_list);
+	if (update->flags & QP_NOTI_UPDATE_PROGRESS)
+		state->progress = update->progress;
 
-		while (head != NULL) {
-			noti = notification_list_get_data(head);
-			notification_get_pkgname(noti, &noti_pkgname);
-			notification_get_id(noti, NULL, &noti_priv_id);
-			if (!strcmp(noti_pkgname, pkgname)
-			    && priv_id == noti_priv_id) {
-				notification_set_size(noti, size);
-				return noti;
-			}
-			head = notification_list_get_next(head);
-		}
+	if (update->flags & QP_NOTI_UPDATE_SIZE)
+		state->size = update->size;
+
+	if (update->flags & QP_NOTI_UPDATE_CONTENT) {
+		free(state->content);
+		state->content = update->content ?
+				strdup(update->content) : NULL;
 	}
 
-	return NULL;
+	state->flags |= update->flags;
+	notification_get_insert_time(noti, &state->insert_time);
 }
 
-static notification_h _quickpanel_noti_update_item_content(const char *pkgname,
-							int priv_id,
-							char *content)
+static Eina_Bool _quickpanel_noti_update_flush_cb(void *data)
 {
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+	noti_node_item *node = NULL;
 	notification_h noti = NULL;
-	notification_list_h head = NULL;
-	char *noti_pkgname = NULL;
-	int noti_priv_id = 0;
-
-	if (g_notification_ongoing_list) {
-		head = notification_list_get_head(g_notification_ongoing_list);
-
-		while (head != NULL) {
-			noti = notification_list_get_data(head);
-			notification_get_pkgname(noti, &noti_pkgname);
-			notification_get_id(noti, NULL, &noti_priv_id);
-			if (!strcmp(noti_pkgname, pkgname)
-			    && priv_id == noti_priv_id) {
-				notification_set_text(noti,
-					NOTIFICATION_TEXT_TYPE_CONTENT,
-					content, NULL,
-					NOTIFICATION_VARIABLE_TYPE_NONE);
-				return noti;
-			}
-			head = notification_list_get_next(head);
-		}
-	}
+	qp_noti_update_item *update = NULL;
+	int mode = QP_NOTI_PROGRESS_NONE;
+	int count = 0;
 
-	if (g_notification_list) {
-		head = notification_list_get_head(g_notification_list);
-
-		while (head != NULL) {
-			noti = notification_list_get_data(head);
-			notification_get_pkgname(noti, &noti_pkgname);
-			notification_get_id(noti, NULL, &noti_priv_id);
-			if (!strcmp(noti_pkgname, pkgname)
-			    && priv_id == noti_priv_id) {
-				notification_set_text(noti,
-					NOTIFICATION_TEXT_TYPE_CONTENT,
-					content, NULL,
-					NOTIFICATION_VARIABLE_TYPE_NONE);
-				return noti;
-			}
-			head = notification_list_get_next(head);
+	g_update_animator = NULL;
+
+	retif(!g_update_table, ECORE_CALLBACK_CANCEL, "update table is NULL");
+
+	g_hash_table_iter_init(&iter, g_update_table);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		update = value;
+
+		/* not shown, the mirrored one is what the next reconcile reads */
+		node = quickpanel_noti_node_get_by_key(key);
+		if (!node || !node->noti) {
+			noti = quickpanel_noti_db_find(key);
+			if (!noti)
+				continue;
+
+			_quickpanel_noti_update_apply(noti, update);
+			_quickpanel_noti_update_keep(key, noti, update);
+			g_update_stats.applied++;
+			count++;
+			continue;
 		}
+
+		mode = _quickpanel_noti_progress_mode(node->noti);
+
+		_quickpanel_noti_update_apply(node->noti, update);
+		_quickpanel_noti_update_keep(key, node->noti, update);
+		quickpanel_noti_node_set_render(node, NULL);
+		g_update_stats.applied++;
+		count++;
+
+		if (!suspended)
+			_quickpanel_noti_update_item_view(data, node,
+					update->flags, mode);
 	}
 
-	return NULL;
+	g_hash_table_remove_all(g_update_table);
+	g_update_stats.frames++;
+
+	DBG("flush %d updates, received[%u] coalesced[%u] applied[%u]",
+		count, g_update_stats.received, g_update_stats.coalesced,
+		g_update_stats.applied);
+
+	return ECORE_CALLBACK_CANCEL;
 }
 
-static void _quickpanel_noti_update_progressbar(void *data,
-						notification_h update_noti)
+static qp_noti_update_item *_quickpanel_noti_update_get(void *data,
+							const char *pkgname,
+							int priv_id)
 {
-	struct appdata *ad = NULL;
-	Elm_Object_Item *found = NULL;
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	qp_noti_update_item *update = NULL;
+	char *key = NULL;
 
-	retif(!data, , "data is NULL");
-	ad = data;
+	retif(!g_update_table, NULL, "update table is NULL");
 
-	retif(!ad->list, , "ad->list is NULL");
+	if (!quickpanel_noti_node_make_key_by_id(pkgname, priv_id,
+						buf, sizeof(buf)))
+		return NULL;
 
-	if (ad->show_setting)
-		found = quickpanel_list_util_find_item_by_type(ad->list,
-				update_noti, ongoing_first,
-				QP_ITEM_TYPE_ONGOING_NOTI);
-	else
-		found = quickpanel_list_util_find_item_by_type(ad->list,
-				update_noti, noti_first,
-				QP_ITEM_TYPE_NOTI);
+	/* shown or collapsed, signals for unknown notifications are dropped */
+	retif(quickpanel_noti_node_get_by_key(buf) == NULL
+		&& quickpanel_noti_db_find(buf) == NULL, NULL,
+		"Can not found noti data.");
+
+	g_update_stats.received++;
+
+	update = g_hash_table_lookup(g_update_table, buf);
+	if (update) {
+		g_update_stats.coalesced++;
+		return update;
+	}
+
+	update = calloc(1, sizeof(qp_noti_update_item));
+	retif(update == NULL, NULL, "fail to alloc update");
+
+	key = strdup(buf);
+	if (!key) {
+		ERR("fail to alloc key");
+		free(update);
+		return NULL;
+	}
 
-	retif(!found, , "fail to find %p related gl item", update_noti);
+	g_hash_table_insert(g_update_table, key, update);
 
-	elm_genlist_item_fields_update(found, "*", ELM_GENLIST_ITEM_FIELD_ALL);
+	if (!g_update_animator)
+		g_update_animator = ecore_animator_add(
+				_quickpanel_noti_update_flush_cb, data);
+
+	return update;
 }
 
 static void _quickpanel_noti_item_progress_update_cb(void *data,
@@ -315,7 +548,7 @@ static void _quickpanel_noti_item_progress_update_cb(void *data,
 	char *pkgname = 0;
 	int priv_id = 0;
 	double progress = 0;
-	notification_h noti = NULL;
+	qp_noti_update_item *update = NULL;
 
 	retif(data == NULL || msg == NULL, , "Invalid parameter!");
 
@@ -332,15 +565,12 @@ static void _quickpanel_noti_item_progress_update_cb(void *data,
 		return;
 	}
 
-	/* check item on the list */
-	noti = _quickpanel_noti_update_item_progress(pkgname,
-						priv_id, progress);
-	retif(noti == NULL, , "Can not found noti data.");
+	/* keep only the latest value until the next frame */
+	update = _quickpanel_noti_update_get(data, pkgname, priv_id);
+	retif(update == NULL, , "fail to queue update");
 
-	DBG("pkgname[%s], priv_id[%d], progress[%lf]",
-				pkgname, priv_id, progress);
-	if (!suspended)
-		_quickpanel_noti_update_progressbar(data, noti);
+	update->flags |= QP_NOTI_UPDATE_PROGRESS;
+	update->progress = progress;
 }
 
 static void _quickpanel_noti_item_size_update_cb(void *data, DBusMessage * msg)
@@ -349,7 +579,7 @@ static void _quickpanel_noti_item_size_update_cb(void *data, DBusMessage * msg)
 	char *pkgname = 0;
 	int priv_id = 0;
 	double size = 0;
-	notification_h noti = NULL;
+	qp_noti_update_item *update = NULL;
 
 	retif(data == NULL || msg == NULL, , "Invalid parameter!");
 
@@ -364,15 +594,11 @@ static void _quickpanel_noti_item_size_update_cb(void *data, DBusMessage * msg)
 		return;
 	}
 
-	/* check item on the list */
-	noti = _quickpanel_noti_update_item_size(pkgname, priv_id, size);
-	retif(noti == NULL, , "Can not found noti data.");
-
-	DBG("pkgname[%s], priv_id[%d], progress[%lf]",
-				pkgname, priv_id, size);
+	update = _quickpanel_noti_update_get(data, pkgname, priv_id);
+	retif(update == NULL, , "fail to queue update");
 
-	if (!suspended)
-		_quickpanel_noti_update_progressbar(data, noti);
+	update->flags |= QP_NOTI_UPDATE_SIZE;
+	update->size = size;
 }
 
 static void _quickpanel_noti_item_content_update_cb(void *data,
@@ -382,7 +608,7 @@ static void _quickpanel_noti_item_content_update_cb(void *data,
 	char *pkgname = NULL;
 	int priv_id = 0;
 	char *content = NULL;
-	notification_h noti = NULL;
+	qp_noti_update_item *update = NULL;
 
 	retif(data == NULL || msg == NULL, , "Invalid parameter!");
 
@@ -401,43 +627,199 @@ static void _quickpanel_noti_item_content_update_cb(void *data,
 	DBG("pkgname[%s], priv_id[%d], content[%s]",
 				pkgname, priv_id, content);
 
-	/* check item on the list */
-	noti = _quickpanel_noti_update_item_content(pkgname, priv_id, content);
-	retif(noti == NULL, , "Can not found noti data.");
+	update = _quickpanel_noti_update_get(data, pkgname, priv_id);
+	retif(update == NULL, , "fail to queue update");
+
+	if (update->content)
+		free(update->content);
 
-	if (!suspended)
-		_quickpanel_noti_update_progressbar(data, noti);
+	update->content = content ? strdup(content) : NULL;
+	update->flags |= QP_NOTI_UPDATE_CONTENT;
 }
 
-static char *_quickpanel_noti_get_time(time_t t, char *buf, int buf_len)
+void quickpanel_noti_get_update_stats(qp_noti_update_stats *stats)
+{
+	retif(stats == NULL, , "Invalid parameter!");
+
+	*stats = g_update_stats;
+}
+
+void quickpanel_noti_set_limit(int max_items, int max_per_app)
+{
+	if (max_items > 0)
+		g_noti_max_items = max_items;
+	if (max_per_app > 0)
+		g_noti_max_per_app = max_per_app;
+
+	INFO("limit items[%d] per app[%d]", g_noti_max_items,
+		g_noti_max_per_app);
+}
+
+static void _quickpanel_noti_update_init(void)
+{
+	if (g_update_table)
+		return;
+
+	g_update_table = g_hash_table_new_full(g_str_hash, g_str_equal,
+				free, _quickpanel_noti_update_item_free);
+	g_update_state = g_hash_table_new_full(g_str_hash, g_str_equal,
+				free, _quickpanel_noti_update_item_free);
+	memset(&g_update_stats, 0x00, sizeof(g_update_stats));
+}
+
+static void _quickpanel_noti_update_fini(void)
+{
+	if (g_update_animator) {
+		ecore_animator_del(g_update_animator);
+		g_update_animator = NULL;
+	}
+
+	if (g_update_table) {
+		g_hash_table_destroy(g_update_table);
+		g_update_table = NULL;
+	}
+
+	if (g_update_state) {
+		g_hash_table_destroy(g_update_state);
+		g_update_state = NULL;
+	}
+}
+
+/* day boundaries and clock format used by the time labels,
+ * returns 1 if labels made with the previous ones are stale */
+static int _quickpanel_noti_time_info_update(void)
+{
+	struct tm loc_time;
+	time_t now = time(NULL);
+	bool is_24hour_enabled = FALSE;
+	int changed = 0;
+
+	if (!g_time_tomorrow || now < g_time_today || now >= g_time_tomorrow) {
+		localtime_r(&now, &loc_time);
+
+		loc_time.tm_sec = 0;
+		loc_time.tm_min = 0;
+		loc_time.tm_hour = 0;
+		loc_time.tm_isdst = -1;
+		g_time_today = mktime(&loc_time);
+
+		loc_time.tm_mday -= 1;
+		loc_time.tm_isdst = -1;
+		g_time_yesterday = mktime(&loc_time);
+
+		loc_time.tm_mday += 2;
+		loc_time.tm_isdst = -1;
+		g_time_tomorrow = mktime(&loc_time);
+
+		changed = 1;
+	}
+
+	if (runtime_info_get_value_bool(
+			RUNTIME_INFO_KEY_24HOUR_CLOCK_FORMAT_ENABLED,
+			&is_24hour_enabled) == RUNTIME_INFO_ERROR_NONE
+	    && (is_24hour_enabled ? 1 : 0) != g_time_24hour) {
+		g_time_24hour = is_24hour_enabled ? 1 : 0;
+		changed = 1;
+	}
+
+	return changed;
+}
+
+static void _quickpanel_noti_date_formatter_reset(void)
+{
+	if (g_date_formatter) {
+		udat_close(g_date_formatter);
+		g_date_formatter = NULL;
+	}
+
+	g_date_skeleton = NULL;
+}
+
+/* formatters are kept until the language or the region format changes */
+static UDateFormat *_quickpanel_noti_get_date_formatter(
+						const char *skeleton_str)
 {
 	UErrorCode status = U_ZERO_ERROR;
 	UDateTimePatternGenerator *generator;
-	UDateFormat *formatter;
 	UChar skeleton[40] = { 0 };
 	UChar pattern[40] = { 0 };
+	int32_t patternCapacity;
+	int32_t skeletonLength, patternLength;
+	const char *locale;
+
+	if (g_date_formatter && g_date_skeleton
+	    && !strcmp(g_date_skeleton, skeleton_str))
+		return g_date_formatter;
+
+	_quickpanel_noti_date_formatter_reset();
+
+	/* get default locale  */
+	/* for thread saftey  */
+	uloc_setDefault(__secure_getenv("LC_TIME"), &status);
+	locale = uloc_getDefault();
+
+	/* open datetime pattern generator */
+	generator = udatpg_open(locale, &status);
+	if (generator == NULL || U_FAILURE(status)) {
+		if (generator)
+			udatpg_close(generator);
+		return NULL;
+	}
+
+	/* calculate pattern string capacity */
+	patternCapacity =
+	    (int32_t) (sizeof(pattern) / sizeof((pattern)[0]));
+
+	/* ascii to unicode for input skeleton */
+	u_uastrcpy(skeleton, skeleton_str);
+
+	/* get skeleton length */
+	skeletonLength = strlen(skeleton_str);
+
+	/* get best pattern using skeleton */
+	patternLength =
+	    udatpg_getBestPattern(generator, skeleton, skeletonLength,
+				  pattern, patternCapacity, &status);
+
+	/* close datetime pattern generator */
+	udatpg_close(generator);
+
+	/* open datetime formatter using best pattern */
+	g_date_formatter =
+	    udat_open(UDAT_IGNORE, UDAT_DEFAULT, locale, NULL, -1,
+		      pattern, patternLength, &status);
+	if (g_date_formatter == NULL || U_FAILURE(status)) {
+		if (g_date_formatter)
+			udat_close(g_date_formatter);
+		g_date_formatter = NULL;
+		return NULL;
+	}
+
+	g_date_skeleton = skeleton_str;
+
+	DBG("date formatter for locale[%s]", locale);
+
+	return g_date_formatter;
+}
+
+static char *_quickpanel_noti_get_time(time_t t, char *buf, int buf_len)
+{
+	UErrorCode status = U_ZERO_ERROR;
+	UDateFormat *formatter;
 	UChar formatted[40] = { 0 };
-	int32_t patternCapacity, formattedCapacity;
-	int32_t skeletonLength, patternLength, formattedLength;
+	int32_t formattedCapacity;
 	UDate date;
-	const char *locale;
-	const char customSkeleton[] = UDAT_YEAR_NUM_MONTH_DAY;
 	char bf1[32] = { 0, };
-	bool is_24hour_enabled = FALSE;
 
 	struct tm loc_time;
 	time_t today, yesterday;
 	int ret = 0;
 
-	today = time(NULL);
-	localtime_r(&today, &loc_time);
+	if (!g_time_tomorrow)
+		_quickpanel_noti_time_info_update();
 
-	loc_time.tm_sec = 0;
-	loc_time.tm_min = 0;
-	loc_time.tm_hour = 0;
-	today = mktime(&loc_time);
-
-	yesterday = today - QP_NOTI_DAY_DEC;
+	today = g_time_today;
+	yesterday = g_time_yesterday;
 
 	localtime_r(&t, &loc_time);
 
@@ -447,63 +829,25 @@ static char *_quickpanel_noti_get_time(time_t t, char *buf, int buf_len)
 		/* set UDate  from time_t */
 		date = (UDate) t * 1000;
 
-		/* get default locale  */
-		/* for thread saftey  */
-		uloc_setDefault(__secure_getenv("LC_TIME"), &status);
-		locale = uloc_getDefault();
-
-		/* open datetime pattern generator */
-		generator = udatpg_open(locale, &status);
-		if (generator == NULL)
-			return NULL;
-
-		/* calculate pattern string capacity */
-		patternCapacity =
-		    (int32_t) (sizeof(pattern) / sizeof((pattern)[0]));
-
-		/* ascii to unicode for input skeleton */
-		u_uastrcpy(skeleton, customSkeleton);
-
-		/* get skeleton length */
-		skeletonLength = strlen(customSkeleton);
-
-		/* get best pattern using skeleton */
-		patternLength =
-		    udatpg_getBestPattern(generator, skeleton, skeletonLength,
-					  pattern, patternCapacity, &status);
-
-		/* open datetime formatter using best pattern */
-		formatter =
-		    udat_open(UDAT_IGNORE, UDAT_DEFAULT, locale, NULL, -1,
-			      pattern, patternLength, &status);
-		if (formatter == NULL) {
-			udatpg_close(generator);
+		formatter = _quickpanel_noti_get_date_formatter(
+				UDAT_YEAR_NUM_MONTH_DAY);
+		if (formatter == NULL)
 			return NULL;
-		}
 
 		/* calculate formatted string capacity */
 		formattedCapacity =
 		    (int32_t) (sizeof(formatted) / sizeof((formatted)[0]));
 
 		/* formatting date using formatter by best pattern */
-		formattedLength =
-		    udat_format(formatter, date, formatted, formattedCapacity,
+		udat_format(formatter, date, formatted, formattedCapacity,
 				NULL, &status);
 
 		/* unicode to ascii to display */
 		u_austrcpy(bf1, formatted);
 
-		/* close datetime pattern generator */
-		udatpg_close(generator);
-
-		/* close datetime formatter */
-		udat_close(formatter);
-
 		ret = snprintf(buf, buf_len, "%s", bf1);
 	} else {
-		ret = runtime_info_get_value_bool(
-					RUNTIME_INFO_KEY_24HOUR_CLOCK_FORMAT_ENABLED, &is_24hour_enabled);
-		if (ret == RUNTIME_INFO_ERROR_NONE && is_24hour_enabled == TRUE) {
+		if (g_time_24hour) {
 			ret = strftime(buf, buf_len, "%H:%M", &loc_time);
 		} else {
 			strftime(bf1, sizeof(bf1), "%l:%M", &loc_time);
@@ -519,108 +863,45 @@ static char *_quickpanel_noti_get_time(time_t t, char *buf, int buf_len)
 	return ret <= 0 ? NULL : buf;
 }
 
-static Evas_Object *_quickpanel_noti_gl_get_content(void *data,
-					Evas_Object *obj, const char *part)
+static char *__noti_text_dup(notification_h noti, notification_text_type_e type)
 {
-	qp_item_data *qid = NULL;
-	notification_h noti = NULL;
-	Evas_Object *ic = NULL;
-	char *icon_path = NULL;
-	char *thumbnail_path = NULL;
-	char *ret_path = NULL;
-	double size = 0.0;
-	double percentage = 0.0;
-	notification_type_e type = NOTIFICATION_TYPE_NONE;
-
-	retif(!data, NULL, "data is NULL");
-	qid = data;
-
-	noti = quickpanel_list_util_item_get_data(qid);
-	retif(noti == NULL, NULL, "noti is NULL");
-
-	if (!strncmp
-	    (part, "elm.swallow.progress", strlen("elm.swallow.progress"))) {
-		notification_get_type(noti, &type);
-		if (type == NOTIFICATION_TYPE_ONGOING) {
-			notification_get_size(noti, &size);
-			notification_get_progress(noti, &percentage);
-
-			if (percentage > 0 && percentage <= 1) {
-				ic = elm_progressbar_add(obj);
-				if (ic == NULL)
-					return NULL;
-
-				elm_object_style_set(ic, "list_progress");
-				elm_progressbar_value_set(ic, percentage);
-				elm_progressbar_horizontal_set(ic, EINA_TRUE);
-				elm_progressbar_pulse(ic, EINA_FALSE);
-			} else if (size > 0) {
-				ic = elm_progressbar_add(obj);
-				if (ic == NULL)
-					return NULL;
-
-				elm_object_style_set(ic, "pending_list");
-				elm_progressbar_horizontal_set(ic, EINA_TRUE);
-				elm_progressbar_pulse(ic, EINA_TRUE);
-			}
-		}
-		return ic;
-	}
-
-	ic = elm_icon_add(obj);
-	retif(ic == NULL, NULL, "Failed to create elm icon.");
-
-	notification_get_image(noti, NOTIFICATION_IMAGE_TYPE_THUMBNAIL,
-			       &thumbnail_path);
-	notification_get_image(noti, NOTIFICATION_IMAGE_TYPE_ICON, &icon_path);
+	char *text = NULL;
 
-	if (!strncmp
-	    (part, "elm.swallow.thumbnail", strlen("elm.swallow.thumbnail"))) {
-		if (thumbnail_path == NULL)
-			ret_path = icon_path;
-		else
-			ret_path = thumbnail_path;
+	if (notification_get_text(noti, type, &text) != NOTIFICATION_ERROR_NONE
+	    || text == NULL)
+		return NULL;
 
-		elm_icon_resizable_set(ic, EINA_FALSE, EINA_TRUE);
+	return strdup(text);
+}
 
-		if (ret_path == NULL
-		    || (elm_icon_file_set(ic, ret_path, NULL) == EINA_FALSE))
-			elm_icon_file_set(ic, QP_DEFAULT_ICON, NULL);
-	} else if (!strncmp(part, "elm.swallow.icon",
-			strlen("elm.swallow.icon"))) {
-		if (thumbnail_path == NULL)
-			ret_path = NULL;
-		else
-			ret_path = icon_path;
+static char *__noti_image_dup(notification_h noti,
+				notification_image_type_e type)
+{
+	char *path = NULL;
 
-		if (ret_path != NULL)
-			elm_icon_file_set(ic, ret_path, NULL);
-	}
+	if (notification_get_image(noti, type, &path) != NOTIFICATION_ERROR_NONE
+	    || path == NULL)
+		return NULL;
 
-	return ic;
+	return strdup(path);
 }
 
-static char *_quickpanel_noti_gl_get_text(void *data, Evas_Object * obj,
-					   const char *part)
+static noti_node_render *_quickpanel_noti_render_new(notification_h noti)
 {
-	qp_item_data *qid = NULL;
-	notification_h noti = NULL;
-	notification_error_e noti_err = NOTIFICATION_ERROR_NONE;
-	char *text = NULL;
+	noti_node_render *render = NULL;
 	char *domain = NULL;
 	char *dir = NULL;
 	char *pkgname = NULL;
 	char *caller_pkgname = NULL;
-	int group_id = 0, priv_id = 0, count = 0;
+	int group_id = 0, priv_id = 0;
 	char buf[128] = { 0, };
-	time_t time;
-	notification_type_e type = NOTIFICATION_TYPE_NONE;
+	char *text = NULL;
+	time_t time = 0;
 
-	retif(!data, NULL, "data is NULL");
-	qid = data;
+	retif(noti == NULL, NULL, "Invalid parameter!");
 
-	noti = quickpanel_list_util_item_get_data(qid);
-	retif(noti == NULL, NULL, "noti is NULL");
+	render = quickpanel_noti_node_render_new();
+	retif(render == NULL, NULL, "fail to alloc render");
 
 	/* Set text domain */
 	notification_get_text_domain(noti, &domain, &dir);
@@ -631,127 +912,275 @@ static char *_quickpanel_noti_gl_get_text(void *data, Evas_Object * obj,
 	notification_get_pkgname(noti, &pkgname);
 	notification_get_application(noti, &caller_pkgname);
 	notification_get_id(noti, &group_id, &priv_id);
-	notification_get_type(noti, &type);
+	notification_get_type(noti, &render->type);
+	notification_get_size(noti, &render->size);
+	notification_get_progress(noti, &render->progress);
+	if (group_id != NOTIFICATION_GROUP_ID_NONE)
+		quickpanel_noti_db_get_count(render->type, pkgname,
+				group_id, priv_id, &render->count);
+	else
+		render->count = 1;
+
+	if (caller_pkgname && !strcmp(caller_pkgname, VENDOR".message"))
+		render->is_message = 1;
+
+	render->title = __noti_text_dup(noti, NOTIFICATION_TEXT_TYPE_TITLE);
+	render->content = __noti_text_dup(noti,
+			NOTIFICATION_TEXT_TYPE_CONTENT);
+	render->group_title = __noti_text_dup(noti,
+			NOTIFICATION_TEXT_TYPE_GROUP_TITLE);
+	render->group_content = __noti_text_dup(noti,
+			NOTIFICATION_TEXT_TYPE_GROUP_CONTENT);
+
+	notification_get_time(noti, &time);
+	render->has_time = ((int)time > 0) ? 1 : 0;
+
+	if (render->type == NOTIFICATION_TYPE_ONGOING) {
+		text = _quickpanel_noti_get_progress(noti, buf, sizeof(buf));
+	} else if (render->count <= 1) {
+		if ((int)time <= 0)
+			notification_get_insert_time(noti, &time);
+		text = _quickpanel_noti_get_time(time, buf, sizeof(buf));
+	}
+	render->time = text ? strdup(text) : NULL;
 
-	if (!strcmp(part, "elm.text.title")) {
-		notification_get_count(type, pkgname,
-				       group_id, priv_id, &count);
-		if (count > 1) {
-			/* Multi event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_GROUP_CONTENT,
-					&text);
+	render->icon_path = __noti_image_dup(noti,
+			NOTIFICATION_IMAGE_TYPE_ICON);
+	render->thumbnail_path = __noti_image_dup(noti,
+			NOTIFICATION_IMAGE_TYPE_THUMBNAIL);
 
-			if (noti_err == NOTIFICATION_ERROR_NONE && text == NULL) {
-				text = NULL;
-			} else {
-				noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_GROUP_TITLE,
-						&text);
-				if (noti_err != NOTIFICATION_ERROR_NONE)
-					text = NULL;
-			}
-		} else {
-			/* Single event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_CONTENT,
-					&text);
+	return render;
+}
+
+static noti_node_render *_quickpanel_noti_render_more_new(
+					noti_node_item *node)
+{
+	noti_node_render *render = NULL;
+	const char *format = NULL;
+	char buf[128] = { 0, };
+
+	retif(node == NULL, NULL, "Invalid parameter!");
+
+	render = quickpanel_noti_node_render_new();
+	retif(render == NULL, NULL, "fail to alloc render");
+
+	render->type = NOTIFICATION_TYPE_NOTI;
+	render->count = 1;
 
-			if (noti_err == NOTIFICATION_ERROR_NONE && text == NULL) {
-				text = NULL;
+	format = _("IDS_QP_BODY_PD_MORE_FROM_PS");
+	/* not translated yet, gettext hands back the id */
+	if (!strcmp(format, "IDS_QP_BODY_PD_MORE_FROM_PS"))
+		format = "%d more from %s";
+
+	snprintf(buf, sizeof(buf), format,
+		node->more, node->more_label ? node->more_label : "");
+	render->title = strdup(buf);
+
+	if (node->more_icon_path)
+		render->icon_path = strdup(node->more_icon_path);
+
+	return render;
+}
+
+/* returns 1 if the aggregate of the node shows something else now */
+static int _quickpanel_noti_node_set_more(noti_node_item *node,
+					qp_noti_shown_item *entry)
+{
+	retif(node == NULL || entry == NULL, 0, "Invalid parameter!");
+
+	if (node->more == entry->more
+	    && !g_strcmp0(node->more_label, entry->label)
+	    && !g_strcmp0(node->more_icon_path, entry->icon_path))
+		return 0;
+
+	node->more = entry->more;
+
+	free(node->more_label);
+	node->more_label = entry->label ? strdup(entry->label) : NULL;
+
+	free(node->more_icon_path);
+	node->more_icon_path = entry->icon_path ?
+				strdup(entry->icon_path) : NULL;
+
+	return 1;
+}
+
+static noti_node_render *_quickpanel_noti_get_render(noti_node_item *node)
+{
+	retif(node == NULL, NULL, "Invalid parameter!");
+
+	if (node->render)
+		return node->render;
+
+	/* aggregates are rebuilt from the count they were reconciled with */
+	if (node->noti == NULL) {
+		retif(node->more <= 0, NULL, "no notification for node");
+
+		quickpanel_noti_node_set_render(node,
+				_quickpanel_noti_render_more_new(node));
+		return node->render;
+	}
+
+	quickpanel_noti_node_set_render(node,
+			_quickpanel_noti_render_new(node->noti));
+
+	return node->render;
+}
+
+static const char *__render_content(noti_node_render *render, char *buf,
+				int buf_len)
+{
+	if (render->count <= 1)
+		return render->content;
+
+	/* Multi event */
+	if (render->group_content)
+		return render->group_content;
+
+	/* Default string */
+	if (render->is_message) {
+		snprintf(buf, buf_len, "%d %s", render->count,
+			_S("IDS_COM_POP_NEW_MESSAGES"));
+		return buf;
+	}
+
+	return NULL;
+}
+
+static Evas_Object *_quickpanel_noti_gl_get_content(void *data,
+					Evas_Object *obj, const char *part)
+{
+	qp_item_data *qid = NULL;
+	noti_node_item *node = NULL;
+	noti_node_render *render = NULL;
+	Evas_Object *ic = NULL;
+	Evas_Object *progress = NULL;
+	char *ret_path = NULL;
+
+	retif(!data, NULL, "data is NULL");
+	qid = data;
+
+	node = quickpanel_list_util_item_get_data(qid);
+	render = _quickpanel_noti_get_render(node);
+	retif(render == NULL, NULL, "render is NULL");
+
+	/* contents are pooled, reset every property a previous row set */
+	if (!strncmp
+	    (part, "elm.swallow.progress", strlen("elm.swallow.progress"))) {
+		if (render->type == NOTIFICATION_TYPE_ONGOING) {
+			progress = node->progress;
+			_quickpanel_noti_progress_unset(node);
+
+			if (render->progress > 0 && render->progress <= 1) {
+				ic = _quickpanel_noti_content_bind(&progress,
+						QP_NOTI_POOL_PROGRESS);
+				if (ic == NULL)
+					return NULL;
+
+				elm_progressbar_value_set(ic, render->progress);
+				_quickpanel_noti_progress_set(node, ic);
+			} else if (render->size > 0) {
+				ic = _quickpanel_noti_content_bind(&progress,
+						QP_NOTI_POOL_PENDING);
+				if (ic == NULL)
+					return NULL;
+
+				_quickpanel_noti_progress_set(node, ic);
 			} else {
-				noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_TITLE,
-						&text);
-				if (noti_err != NOTIFICATION_ERROR_NONE)
-					text = NULL;
+				_quickpanel_noti_content_unbind(&progress);
 			}
 		}
-	} else if (!strcmp(part, "elm.text.title.only")) {
-		notification_get_count(type, pkgname,
-				       group_id, priv_id, &count);
-		if (count > 1) {
-			/* Multi event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_GROUP_CONTENT,
-					&text);
+		return ic;
+	}
 
-			if (noti_err != NOTIFICATION_ERROR_NONE || text != NULL) {
-				text = NULL;
-			} else {
-				noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_GROUP_TITLE,
-						&text);
-				if (noti_err != NOTIFICATION_ERROR_NONE)
-					text = NULL;
-			}
+	if (!strncmp
+	    (part, "elm.swallow.thumbnail", strlen("elm.swallow.thumbnail"))) {
+		ic = _quickpanel_noti_content_bind(&node->thumbnail,
+				QP_NOTI_POOL_ICON);
+		retif(ic == NULL, NULL, "Failed to create elm icon.");
+
+		if (render->thumbnail_path == NULL)
+			ret_path = render->icon_path;
+		else
+			ret_path = render->thumbnail_path;
+
+		elm_icon_resizable_set(ic, EINA_FALSE, EINA_TRUE);
+
+		if (render->thumbnail_path != NULL) {
+			/* photos are decoded scaled down, off the main loop */
+			if (!quickpanel_icon_cache_file_set_async(ic, ret_path,
+					(int)(QP_NOTI_THUMBNAIL_SIZE
+					 * elm_config_scale_get()),
+					QP_DEFAULT_ICON))
+				quickpanel_icon_cache_file_set(ic,
+						QP_DEFAULT_ICON, 0);
+		} else if (ret_path == NULL
+		    || !quickpanel_icon_cache_file_set(ic, ret_path, 0)) {
+			quickpanel_icon_cache_file_set(ic, QP_DEFAULT_ICON, 0);
+		}
+	} else if (!strncmp(part, "elm.swallow.icon",
+			strlen("elm.swallow.icon"))) {
+		if (render->thumbnail_path == NULL)
+			ret_path = NULL;
+		else
+			ret_path = render->icon_path;
+
+		/* nothing to show, an empty icon is not needed */
+		if (ret_path == NULL) {
+			_quickpanel_noti_content_unbind(&node->icon);
+			return NULL;
+		}
+
+		ic = _quickpanel_noti_content_bind(&node->icon,
+				QP_NOTI_POOL_ICON);
+		retif(ic == NULL, NULL, "Failed to create elm icon.");
+
+		elm_icon_resizable_set(ic, EINA_TRUE, EINA_TRUE);
+		quickpanel_icon_cache_file_set(ic, ret_path, 0);
+	}
+
+	return ic;
+}
+
+static char *_quickpanel_noti_gl_get_text(void *data, Evas_Object * obj,
+					   const char *part)
+{
+	qp_item_data *qid = NULL;
+	noti_node_render *render = NULL;
+	const char *text = NULL;
+	char buf[128] = { 0, };
+
+	retif(!data, NULL, "data is NULL");
+	qid = data;
+
+	render = _quickpanel_noti_get_render(
+			quickpanel_list_util_item_get_data(qid));
+	retif(render == NULL, NULL, "render is NULL");
+
+	if (!strcmp(part, "elm.text.title")) {
+		if (render->count > 1) {
+			/* Multi event */
+			if (render->group_content != NULL)
+				text = render->group_title;
 		} else {
 			/* Single event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_CONTENT,
-					&text);
-			DBG("result:%d, %x", noti_err, text);
-			if (noti_err != NOTIFICATION_ERROR_NONE || text != NULL) {
-				text = NULL;
-			} else {
-				noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_TITLE,
-						&text);
-				if (noti_err != NOTIFICATION_ERROR_NONE)
-					text = NULL;
-			}
+			if (render->content != NULL)
+				text = render->title;
 		}
-	} else if (!strcmp(part, "elm.text.content")) {
-		notification_get_count(type, pkgname,
-				       group_id, priv_id, &count);
-
-		if (count > 1) {
+	} else if (!strcmp(part, "elm.text.title.only")) {
+		if (render->count > 1) {
 			/* Multi event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_GROUP_CONTENT,
-					&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-
-			if (text == NULL) {
-				/* Default string */
-				if (!strcmp(caller_pkgname,
-					 VENDOR".message")) {
-					snprintf(buf, sizeof(buf), "%d %s",
-						count,
-						_S("IDS_COM_POP_NEW_MESSAGES"));
-					text = buf;
-				}
-			}
+			if (render->group_content == NULL)
+				text = render->group_title;
 		} else {
 			/* Single event */
-			noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_CONTENT,
-						&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
+			if (render->content == NULL)
+				text = render->title;
 		}
+	} else if (!strcmp(part, "elm.text.content")) {
+		text = __render_content(render, buf, sizeof(buf));
 	} else if (!strcmp(part, "elm.text.time")) {
-		if (type == NOTIFICATION_TYPE_ONGOING)
-			text = _quickpanel_noti_get_progress(noti, buf,
-							  sizeof(buf));
-		else {
-			notification_get_count(type, pkgname,
-					       group_id, priv_id, &count);
-
-			if (count <= 1) {
-				notification_get_time(noti, &time);
-
-				if ((int)time > 0)
-					text = _quickpanel_noti_get_time(time, buf,
-									  sizeof(buf));
-				else {
-					notification_get_insert_time(noti, &time);
-					text = _quickpanel_noti_get_time(time, buf,
-									  sizeof(buf));
-				}
-			}
-		}
+		text = render->time;
 	}
 
 	if (text != NULL)
@@ -764,139 +1193,45 @@ static char *_quickpanel_ongoing_noti_gl_get_text(void *data, Evas_Object * obj,
 					   const char *part)
 {
 	qp_item_data *qid = NULL;
-	notification_h noti = NULL;
-	notification_error_e noti_err = NOTIFICATION_ERROR_NONE;
-	char *text = NULL;
-	char *domain = NULL;
-	char *dir = NULL;
-	char *pkgname = NULL;
-	char *caller_pkgname = NULL;
-	int group_id = 0, priv_id = 0, count = 0;
+	noti_node_render *render = NULL;
+	const char *text = NULL;
 	char buf[128] = { 0, };
-	time_t time;
-	notification_type_e type = NOTIFICATION_TYPE_NONE;
-	double size = 0.0;
-	double percentage = 0.0;
 	int isProgressBarEnabled = 1;
 
 	retif(!data, NULL, "data is NULL");
 	qid = data;
 
-	noti = quickpanel_list_util_item_get_data(qid);
-	retif(noti == NULL, NULL, "noti is NULL");
+	render = _quickpanel_noti_get_render(
+			quickpanel_list_util_item_get_data(qid));
+	retif(render == NULL, NULL, "render is NULL");
 
-	/* Set text domain */
-	notification_get_text_domain(noti, &domain, &dir);
-	if (domain != NULL && dir != NULL)
-		bindtextdomain(domain, dir);
-
-	/* Get pkgname & id */
-	notification_get_pkgname(noti, &pkgname);
-	notification_get_application(noti, &caller_pkgname);
-	notification_get_id(noti, &group_id, &priv_id);
-	notification_get_type(noti, &type);
-	notification_get_size(noti, &size);
-	notification_get_progress(noti, &percentage);
-
-	DBG("percentage:%f size:%f", percentage, size);
-
-	if (percentage <= 0.0 && size <= 0.0) {
+	if (render->progress <= 0.0 && render->size <= 0.0) {
 		isProgressBarEnabled = 0;
 	}
 
 	if (!strcmp(part, "elm.text.title")) {
-		notification_get_count(type, pkgname,
-				       group_id, priv_id, &count);
-		if (count > 1) {
-			/* Multi event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_GROUP_TITLE,
-					&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-		} else {
-			/* Single event */
-			noti_err = notification_get_text(noti,
-									NOTIFICATION_TEXT_TYPE_TITLE,
-									&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-		}
+		if (render->count > 1)
+			text = render->group_title;
+		else
+			text = render->title;
 	} else if (!strcmp(part, "elm.text.content")) {
 
 		if (isProgressBarEnabled == 0)
 			return NULL;
 
-		notification_get_count(type, pkgname,
-				       group_id, priv_id, &count);
-
-		if (count > 1) {
-			/* Multi event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_GROUP_CONTENT,
-					&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-
-			if (text == NULL) {
-				/* Default string */
-				if (!strcmp(caller_pkgname,
-					 VENDOR".message")) {
-					snprintf(buf, sizeof(buf), "%d %s",
-						count,
-						_S("IDS_COM_POP_NEW_MESSAGES"));
-					text = buf;
-				}
-			}
-		} else {
-			/* Single event */
-			noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_CONTENT,
-						&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-		}
+		text = __render_content(render, buf, sizeof(buf));
 	} else if (!strcmp(part, "elm.text.content.no.progress")) {
 
 		if (isProgressBarEnabled == 1)
 			return NULL;
 
-		notification_get_count(type, pkgname,
-				       group_id, priv_id, &count);
-
-		if (count > 1) {
-			/* Multi event */
-			noti_err = notification_get_text(noti,
-					NOTIFICATION_TEXT_TYPE_GROUP_CONTENT,
-					&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-
-			if (text == NULL) {
-				/* Default string */
-				if (!strcmp(caller_pkgname,
-					 VENDOR".message")) {
-					snprintf(buf, sizeof(buf), "%d %s",
-						count,
-						_S("IDS_COM_POP_NEW_MESSAGES"));
-					text = buf;
-				}
-			}
-		} else {
-			/* Single event */
-			noti_err = notification_get_text(noti,
-						NOTIFICATION_TEXT_TYPE_CONTENT,
-						&text);
-			if (noti_err != NOTIFICATION_ERROR_NONE)
-				text = NULL;
-		}
+		text = __render_content(render, buf, sizeof(buf));
 	} else if (!strcmp(part, "elm.text.time")) {
 
 		if (isProgressBarEnabled == 0)
 			return NULL;
 
-		text = _quickpanel_noti_get_progress(noti, buf,
-									  sizeof(buf));
+		text = render->time;
 	}
 
 	if (text != NULL)
@@ -909,40 +1244,54 @@ static Eina_Bool _quickpanel_noti_gl_get_state(void *data, Evas_Object * obj,
 					       const char *part)
 {
 	qp_item_data *qid = NULL;
-	notification_h noti = NULL;
-	char *pkgname = NULL;
-	int group_id = 0, priv_id = 0;
-	char *content = NULL;
-	time_t time;
+	noti_node_render *render = NULL;
 
 	retif(!data, EINA_FALSE, "data is NULL");
 	qid = data;
 
-	noti = quickpanel_list_util_item_get_data(qid);
-	retif(noti == NULL, EINA_FALSE, "noti is NULL");
-
-	notification_get_pkgname(noti, &pkgname);
-	notification_get_id(noti, &group_id, &priv_id);
+	render = _quickpanel_noti_get_render(
+			quickpanel_list_util_item_get_data(qid));
+	retif(render == NULL, EINA_FALSE, "render is NULL");
 
 	if (!strcmp(part, "elm.text.content")) {
-		notification_get_text(noti,
-			NOTIFICATION_TEXT_TYPE_CONTENT, &content);
-		if (content != NULL)
+		if (render->content != NULL)
 			return EINA_TRUE;
 	} else if (!strcmp(part, "elm.text.time")) {
-		notification_get_time(noti, &time);
-
-		if ((int)time > 0)
+		if (render->has_time)
 			return EINA_TRUE;
 	}
 
 	return EINA_FALSE;
 }
 
+static void _quickpanel_noti_expand(struct appdata *ad, const char *key)
+{
+	char *pkgname = NULL;
+	int len = 0;
+
+	retif(ad == NULL || key == NULL, , "Invalid parameter!");
+
+	len = strlen(key) - strlen(QP_NOTI_MORE_SUFFIX);
+	retif(len <= 0, , "Invalid key!");
+
+	pkgname = strndup(key, len);
+	retif(pkgname == NULL, , "fail to alloc pkgname");
+
+	if (!g_noti_expanded)
+		g_noti_expanded = g_hash_table_new_full(g_str_hash,
+				g_str_equal, (GDestroyNotify)free, NULL);
+
+	INFO("expand %s", pkgname);
+	g_hash_table_replace(g_noti_expanded, pkgname, pkgname);
+
+	_quickpanel_noti_update_notilist(ad);
+}
+
 static void quickpanel_noti_select_cb(void *data, Evas_Object * obj,
 				      void *event_info)
 {
-	notification_h noti = (notification_h) data;
+	noti_node_item *node = NULL;
+	notification_h noti = NULL;
 	char *pkgname = NULL;
 	char *caller_pkgname = NULL;
 	bundle *args = NULL;
@@ -958,7 +1307,19 @@ static void quickpanel_noti_select_cb(void *data, Evas_Object * obj,
 	elm_genlist_item_selected_set((Elm_Object_Item *) event_info,
 				      EINA_FALSE);
 
-	retif(noti == NULL, , "Invalid parameter!");
+	/* item data follows list refreshes, func_data would go stale */
+	node = quickpanel_list_util_item_get_data(
+			elm_object_item_data_get(event_info));
+	retif(node == NULL, , "Invalid parameter!");
+
+	/* "N more" aggregate, lift the per app cap for its app */
+	if (node->noti == NULL && node->more > 0) {
+		_quickpanel_noti_expand(data, node->key);
+		return;
+	}
+
+	retif(node->noti == NULL, , "Invalid parameter!");
+	noti = node->noti;
 
 	notification_get_pkgname(noti, &caller_pkgname);
 	notification_get_application(noti, &pkgname);
@@ -988,7 +1349,7 @@ static void quickpanel_noti_select_cb(void *data, Evas_Object * obj,
 
 	if (flag_launch == 1) {
 		if (group_id != NOTIFICATION_GROUP_ID_NONE)
-			notification_get_count(type,
+			quickpanel_noti_db_get_count(type,
 					caller_pkgname, group_id,
 					priv_id, &count);
 		else
@@ -1028,6 +1389,10 @@ static Evas_Object *_quickpanel_noti_gl_get_group_content(void *data,
 {
 	Evas_Object *eo = NULL;
 
+	/* one group title, its button is kept across realizations */
+	if (g_clear_button)
+		return g_clear_button;
+
 	eo = elm_button_add(obj);
 	retif(eo == NULL, NULL, "Failed to create clear button!");
 
@@ -1037,6 +1402,9 @@ static Evas_Object *_quickpanel_noti_gl_get_group_content(void *data,
 	evas_object_smart_callback_add(eo, "clicked",
 				       _quickpanel_noti_clear_clicked_cb, NULL);
 
+	evas_object_ref(eo);
+	g_clear_button = eo;
+
 	return eo;
 }
 
@@ -1044,34 +1412,16 @@ static char *_quickpanel_noti_gl_get_group_text(void *data, Evas_Object * obj,
 						 const char *part)
 {
 	char buf[128] = { 0, };
-	int noti_count = 0;
-	struct appdata *ad = NULL;
-	qp_item_data *qid = NULL;
 
 	retif(!data, NULL, "data is NULL");
-	qid = data;
-
-	ad = quickpanel_list_util_item_get_data(qid);
-	retif(ad == NULL, NULL, "appdata is NULL");
 
 	if (!strncmp(part, "elm.text", 8)) {
 		const char *format = NULL;
 		memset(buf, 0x00, sizeof(buf));
 
-		if (ad->show_setting) {
-			notification_get_count(NOTIFICATION_TYPE_NOTI, NULL,
-					       NOTIFICATION_GROUP_ID_NONE,
-					       NOTIFICATION_PRIV_ID_NONE,
-					       &noti_count);
-		} else {
-			notification_get_count(NOTIFICATION_TYPE_NONE, NULL,
-					       NOTIFICATION_GROUP_ID_NONE,
-					       NOTIFICATION_PRIV_ID_NONE,
-					       &noti_count);
-		}
-
+		/* kept by the reconcile pass, no store query on realize */
 		format = _("IDS_QP_BODY_NOTIFICATIONS_HPD");
-		snprintf(buf, sizeof(buf), format, noti_count);
+		snprintf(buf, sizeof(buf), format, g_noti_group_count);
 
 		return strdup(buf);
 	}
@@ -1081,14 +1431,45 @@ static char *_quickpanel_noti_gl_get_group_text(void *data, Evas_Object * obj,
 
 static void _quickpanel_noti_gl_del(void *data, Evas_Object *obj)
 {
+	noti_node_item *node = NULL;
+	qp_item_type_e type = QP_ITEM_TYPE_NOTI;
+
 	if (data) {
-		quickpanel_list_util_del_count(data);
-		free(data);
+		type = quickpanel_list_util_item_get_type(data);
+		if (type == QP_ITEM_TYPE_ONGOING_NOTI
+		    || type == QP_ITEM_TYPE_NOTI) {
+			node = quickpanel_list_util_item_get_data(data);
+			/* a moved node may already be shown by a newer item */
+			if (node && node->view
+			    && elm_object_item_data_get(node->view) == data) {
+				_quickpanel_noti_contents_release(node);
+				node->view = NULL;
+			}
+		}
+
+		quickpanel_list_util_item_free(data);
 	}
 
 	return;
 }
 
+static void _quickpanel_noti_gl_unrealized_cb(void *data, Evas_Object *obj,
+					void *event_info)
+{
+	qp_item_data *qid = NULL;
+	qp_item_type_e type = QP_ITEM_TYPE_NOTI;
+
+	qid = elm_object_item_data_get(event_info);
+	if (!qid)
+		return;
+
+	/* contents go away with the realized view, keep them for reuse */
+	type = quickpanel_list_util_item_get_type(qid);
+	if (type == QP_ITEM_TYPE_ONGOING_NOTI || type == QP_ITEM_TYPE_NOTI)
+		_quickpanel_noti_contents_release(
+				quickpanel_list_util_item_get_data(qid));
+}
+
 static void _quickpanel_noti_gl_style_init(void)
 {
 	Elm_Genlist_Item_Class *noti = NULL;
@@ -1122,7 +1503,7 @@ static void _quickpanel_noti_gl_style_init(void)
 		group->item_style = "qp_group_title";
 		group->func.text_get = _quickpanel_noti_gl_get_group_text;
 		group->func.content_get = _quickpanel_noti_gl_get_group_content;
-		noti->func.del = _quickpanel_noti_gl_del;
+		group->func.del = _quickpanel_noti_gl_del;
 		g_itc = group;
 	}
 }
@@ -1145,255 +1526,744 @@ static void _quickpanel_noti_gl_style_fini(void)
 	}
 }
 
-static inline void __ongoing_comp_n_copy(notification_h old, notification_h new)
+static gboolean _quickpanel_noti_update_is_gone(gpointer key, gpointer value,
+						gpointer user_data)
 {
-	int priv_id = 0;
-	int new_priv_id = 0;
-	char *pkgname = NULL;
-	char *new_pkgname = NULL;
+	return (quickpanel_noti_db_find(key) == NULL) ? TRUE : FALSE;
+}
+
+/*
+ * Progress, size and content of ongoing notifications only arrive by DBus,
+ * put the kept values back on the refreshed list. Content belongs to the
+ * notification it was sent for, a reposted one keeps the stored content.
+ */
+static void _quickpanel_noti_merge_ongoing(notification_list_h new_noti_list)
+{
+	notification_list_h new_head = NULL;
+	notification_h new_noti = NULL;
+	notification_type_e new_type = NOTIFICATION_TYPE_NONE;
+	qp_noti_update_item *state = NULL;
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	char *key = NULL;
+	time_t insert_time = 0;
+
+	retif(!g_update_state, , "update state is NULL");
+
+	new_head = notification_list_get_head(new_noti_list);
+	while (new_head != NULL) {
+		new_noti = notification_list_get_data(new_head);
+		new_head = notification_list_get_next(new_head);
+
+		notification_get_type(new_noti, &new_type);
+		if (new_type != NOTIFICATION_TYPE_ONGOING)
+			continue;
+
+		key = quickpanel_noti_node_make_key(new_noti, buf, sizeof(buf));
+		if (!key)
+			continue;
+
+		state = g_hash_table_lookup(g_update_state, key);
+		if (!state)
+			continue;
+
+		notification_get_insert_time(new_noti, &insert_time);
+		if (insert_time != state->insert_time) {
+			state->flags &= ~QP_NOTI_UPDATE_CONTENT;
+			state->insert_time = insert_time;
+		}
+
+		_quickpanel_noti_update_apply(new_noti, state);
+	}
 
-	if (!old)
+	/* the mirror already follows the store here */
+	g_hash_table_foreach_remove(g_update_state,
+			_quickpanel_noti_update_is_gone, NULL);
+}
+
+/* lists are owned by the noti db mirror, previous ones are released
+ * after the mirror listeners ran and the items are reconciled */
+/*
+ * Items needed to fill the visible genlist, the first read of a type is
+ * limited to them and the mirror completes the list when idle
+ */
+static int _quickpanel_noti_get_first_page(struct appdata *ad)
+{
+	int item_h = 0;
+	int count = 0;
+
+	if (itc_noti)
+		item_h = quickpanel_list_util_get_style_height(ad->list,
+				itc_noti->item_style);
+
+	if (item_h > 0 && ad->gl_limit_height > 0)
+		count = ad->gl_limit_height / item_h + 1;
+
+	return (count > QP_NOTI_FIRST_PAGE_MIN) ? count : QP_NOTI_FIRST_PAGE_MIN;
+}
+
+static void _quickpanel_noti_get_new_divided_list(struct appdata *ad)
+{
+	int page = _quickpanel_noti_get_first_page(ad);
+
+	/* Get ongoing list */
+	g_notification_ongoing_list =
+		quickpanel_noti_db_get_list_head(NOTIFICATION_TYPE_ONGOING,
+						page);
+	_quickpanel_noti_merge_ongoing(g_notification_ongoing_list);
+
+	/* Get noti list */
+	g_notification_list =
+		quickpanel_noti_db_get_list_head(NOTIFICATION_TYPE_NOTI, page);
+}
+
+static void _quickpanel_noti_get_new_list(struct appdata *ad)
+{
+	int page = _quickpanel_noti_get_first_page(ad);
+
+	g_notification_ongoing_list = NULL;
+
+	/* Get all list */
+	g_notification_list =
+		quickpanel_noti_db_get_list_head(NOTIFICATION_TYPE_NONE, page);
+	_quickpanel_noti_merge_ongoing(g_notification_list);
+}
+
+static void _quickpanel_noti_clear_ongoinglist(Evas_Object *list)
+{
+	if (!list)
 		return;
 
-	if (!new)
+	quickpanel_list_util_item_del_by_type(list, NULL,
+			QP_ITEM_TYPE_ONGOING_NOTI);
+}
+
+/* drops the group title together with the noti items under it */
+static void _quickpanel_noti_clear_group(Evas_Object *list)
+{
+	if (!list)
 		return;
 
-	notification_get_id(old, NULL, &priv_id);
-	notification_get_id(new, NULL, &new_priv_id);
+	if (!noti_group)
+		return;
 
-	notification_get_pkgname(old, &pkgname);
-	notification_get_pkgname(new, &new_pkgname);
+	quickpanel_list_util_item_del_range(list, QP_ITEM_TYPE_NOTI_GROUP,
+			QP_ITEM_TYPE_NOTI);
+	noti_group = NULL;
+}
+
+static void _quickpanel_noti_clear_list_all(Evas_Object *list)
+{
+	_quickpanel_noti_clear_ongoinglist(list);
+
+	_quickpanel_noti_clear_group(list);
+}
 
-	if (!pkgname || !new_pkgname)
+static void _quickpanel_noti_group_add(Evas_Object *list, void *data)
+{
+	qp_item_data *qid = NULL;
+	Elm_Object_Item *it = NULL;
+
+	if (!list)
 		return;
 
-	if (!strcmp(pkgname, new_pkgname) && priv_id == new_priv_id) {
-		double percentage = 0.0;
-		double size = 0.0;
-		time_t insert_time = 0;
-		time_t new_insert_time = 0;
-
-		notification_get_progress(old, &percentage);
-		notification_get_size(old, &size);
-		notification_set_progress(new, percentage);
-		notification_set_size(new, size);
-		notification_get_insert_time(old, &insert_time);
-		notification_get_insert_time(new, &new_insert_time);
-
-		if (insert_time == new_insert_time) {
-			char *content = NULL;
-			notification_get_text(old,
-				NOTIFICATION_TEXT_TYPE_CONTENT,	&content);
-			notification_set_text(new,
-				NOTIFICATION_TEXT_TYPE_CONTENT,	content,
-				NULL, NOTIFICATION_VARIABLE_TYPE_NONE);
+	qid = quickpanel_list_util_item_new(QP_ITEM_TYPE_NOTI_GROUP, data);
+	if (!qid)
+		return;
+
+	it = quickpanel_list_util_sort_insert(list, g_itc, qid, NULL,
+		ELM_GENLIST_ITEM_GROUP, NULL, NULL);
+
+	if (it)
+		noti_group = it;
+	else {
+		ERR("fail to insert item to list : %p", data);
+		quickpanel_list_util_item_free(qid);
+	}
+
+	DBG("noti group[%p] data[%p] added, it[%p]", qid, data, it);
+}
+
+static inline int __str_diff(const char *str1, const char *str2)
+{
+	if (str1 == str2)
+		return 0;
+
+	if (!str1 || !str2)
+		return 1;
+
+	return strcmp(str1, str2);
+}
+
+static inline int __text_diff(notification_h old, notification_h new,
+				notification_text_type_e type)
+{
+	char *text = NULL;
+	char *new_text = NULL;
+
+	notification_get_text(old, type, &text);
+	notification_get_text(new, type, &new_text);
+
+	return __str_diff(text, new_text);
+}
+
+static inline int __image_diff(notification_h old, notification_h new,
+				notification_image_type_e type)
+{
+	char *path = NULL;
+	char *new_path = NULL;
+
+	notification_get_image(old, type, &path);
+	notification_get_image(new, type, &new_path);
+
+	return __str_diff(path, new_path);
+}
+
+static int __noti_count_changed(noti_node_render *render, notification_h noti)
+{
+	char *pkgname = NULL;
+	int group_id = 0, priv_id = 0, count = 0;
+
+	notification_get_id(noti, &group_id, &priv_id);
+
+	/* only grouped notifications count more than themselves */
+	if (group_id == NOTIFICATION_GROUP_ID_NONE)
+		return 0;
+
+	notification_get_pkgname(noti, &pkgname);
+
+	if (quickpanel_noti_db_get_count(render->type, pkgname, group_id,
+			priv_id, &count) != NOTIFICATION_ERROR_NONE)
+		return 0;
+
+	return (count != render->count) ? 1 : 0;
+}
+
+/* compares everything the item class callbacks render */
+static int __noti_changed(notification_h old, notification_h new)
+{
+	notification_type_e type = NOTIFICATION_TYPE_NONE;
+	notification_type_e new_type = NOTIFICATION_TYPE_NONE;
+	time_t time = 0;
+	time_t new_time = 0;
+	double value = 0.0;
+	double new_value = 0.0;
+
+	if (old == new)
+		return 0;
+
+	if (!old || !new)
+		return 1;
+
+	notification_get_type(old, &type);
+	notification_get_type(new, &new_type);
+	if (type != new_type)
+		return 1;
+
+	notification_get_time(old, &time);
+	notification_get_time(new, &new_time);
+	if (time != new_time)
+		return 1;
+
+	notification_get_insert_time(old, &time);
+	notification_get_insert_time(new, &new_time);
+	if (time != new_time)
+		return 1;
+
+	notification_get_progress(old, &value);
+	notification_get_progress(new, &new_value);
+	if (value != new_value)
+		return 1;
+
+	notification_get_size(old, &value);
+	notification_get_size(new, &new_value);
+	if (value != new_value)
+		return 1;
+
+	if (__text_diff(old, new, NOTIFICATION_TEXT_TYPE_TITLE)
+	    || __text_diff(old, new, NOTIFICATION_TEXT_TYPE_CONTENT)
+	    || __text_diff(old, new, NOTIFICATION_TEXT_TYPE_GROUP_TITLE)
+	    || __text_diff(old, new, NOTIFICATION_TEXT_TYPE_GROUP_CONTENT))
+		return 1;
+
+	if (__image_diff(old, new, NOTIFICATION_IMAGE_TYPE_ICON)
+	    || __image_diff(old, new, NOTIFICATION_IMAGE_TYPE_THUMBNAIL))
+		return 1;
+
+	return 0;
+}
+
+static inline int __noti_is_displayed(notification_h noti)
+{
+	int applist = NOTIFICATION_DISPLAY_APP_ALL;
+
+	if (!noti)
+		return 0;
+
+	notification_get_display_applist(noti, &applist);
+
+	return (applist & NOTIFICATION_DISPLAY_APP_NOTIFICATION_TRAY) ? 1 : 0;
+}
+
+/*
+ * Inserts the pending run of new items after prev, returns the last item
+ * placed so the walk goes on after it.
+ */
+static Elm_Object_Item *_quickpanel_noti_section_flush(Evas_Object *list,
+					Elm_Object_Item *parent,
+					Elm_Object_Item *prev,
+					GArray *batch)
+{
+	qp_item_entry *batch_entry = NULL;
+	noti_node_item *node = NULL;
+	guint i = 0;
+
+	if (batch->len == 0)
+		return prev;
+
+	quickpanel_list_util_bulk_insert(list, parent, prev,
+			(qp_item_entry *)batch->data, batch->len);
+
+	for (i = 0; i < batch->len; i++) {
+		batch_entry = &g_array_index(batch, qp_item_entry, i);
+		node = quickpanel_list_util_item_get_data(batch_entry->qid);
+
+		if (!batch_entry->it) {
+			ERR("fail to insert item to list : %p", node);
+			quickpanel_list_util_item_free(batch_entry->qid);
+			continue;
 		}
+
+		if (node)
+			node->view = batch_entry->it;
+
+		prev = batch_entry->it;
 	}
+
+	g_array_set_size(batch, 0);
+
+	return prev;
 }
 
-static void _quickpanel_noti_get_new_divided_list(void)
+/*
+ * Reconcile one type section of the genlist with a new notification list.
+ * Items are matched by (pkgname, priv_id) through the node index, so only
+ * inserted, removed, moved and changed notifications touch the genlist.
+ * The section is walked between the list_util anchors of item_type.
+ * Nodes must still refer to the previous list when called.
+ * Returns the number of genlist items touched.
+ */
+static int _quickpanel_noti_section_update(Evas_Object *list,
+					GPtrArray *shown,
+					qp_item_type_e item_type,
+					Elm_Genlist_Item_Class *itc,
+					Elm_Object_Item *parent,
+					void *select_data)
 {
-	notification_list_h new_noti_list = NULL;
-	notification_list_h head = NULL;
-	notification_list_h new_head = NULL;
+	GHashTable *desired = NULL;
+	GHashTable *moved = NULL;
+	GList *survivors = NULL;
+	GList *cur = NULL;
+	GList *stale = NULL;
+	GList *l = NULL;
+	qp_noti_shown_item *entry = NULL;
 	notification_h noti = NULL;
-	notification_h new_noti = NULL;
+	noti_node_item *node = NULL;
+	Elm_Object_Item *it = NULL;
+	Elm_Object_Item *prev = NULL;
+	Elm_Object_Item *last = NULL;
+	qp_item_data *qid = NULL;
+	GArray *batch = NULL;
+	qp_item_entry batch_entry;
+	int changed = 0;
+	guint i = 0;
+	int n_kept = 0, n_updated = 0, n_inserted = 0;
+	int n_moved = 0, n_removed = 0;
+
+	retif(list == NULL, 0, "Invalid parameter!");
+
+	/* keys are owned by the entries */
+	desired = g_hash_table_new(g_str_hash, g_str_equal);
+	moved = g_hash_table_new(g_direct_hash, g_direct_equal);
+	batch = g_array_new(FALSE, FALSE, sizeof(qp_item_entry));
+
+	/* keys to be shown, first occurrence wins */
+	for (i = 0; shown && i < shown->len; i++) {
+		entry = g_ptr_array_index(shown, i);
+
+		if (!g_hash_table_lookup(desired, entry->key))
+			g_hash_table_insert(desired, entry->key, entry);
+	}
 
-	/* Get ongoing list */
-	notification_get_grouping_list(NOTIFICATION_TYPE_ONGOING, -1,
-				&new_noti_list);
-	if (g_notification_ongoing_list != NULL) {
-		head = notification_list_get_head(g_notification_ongoing_list);
-		while (head != NULL) {
-			new_head = notification_list_get_head(new_noti_list);
-			while (new_head != NULL) {
-				noti = notification_list_get_data(head);
-				new_noti = notification_list_get_data(new_head);
-
-				__ongoing_comp_n_copy(noti, new_noti);
-
-				new_head = notification_list_get_next(new_head);
+	/* split items on the list into survivors and stale ones */
+	it = quickpanel_list_util_get_first_item(item_type);
+	last = quickpanel_list_util_get_last_item(item_type);
+	while (it) {
+		qid = elm_object_item_data_get(it);
+		node = quickpanel_list_util_item_get_data(qid);
+		if (node && node->view == it
+		    && g_hash_table_lookup(desired, node->key))
+			survivors = g_list_prepend(survivors, it);
+		else
+			stale = g_list_prepend(stale, it);
+
+		if (it == last)
+			break;
+		it = elm_genlist_item_next_get(it);
+	}
+
+	/* survivors were collected backwards */
+	survivors = g_list_reverse(survivors);
+
+	for (l = stale; l != NULL; l = l->next) {
+		elm_object_item_del(l->data);
+		n_removed++;
+	}
+	g_list_free(stale);
+
+	/* walk the wanted order, keep in-place items and place the others */
+	cur = survivors;
+	for (i = 0; shown && i < shown->len; i++) {
+		entry = g_ptr_array_index(shown, i);
+		noti = entry->noti;
+
+		if (g_hash_table_lookup(desired, entry->key) != entry)
+			continue;
+
+		while (cur && g_hash_table_lookup(moved, cur->data))
+			cur = cur->next;
+
+		node = quickpanel_noti_node_get_by_key(entry->key);
+		it = node ? node->view : NULL;
+
+		if (!noti) {
+			/* overflow aggregate, only its count changes */
+			changed = node && _quickpanel_noti_node_set_more(node,
+								entry);
+		} else {
+			changed = node ? __noti_changed(node->noti, noti) : 0;
+
+			/* replaced while the list was not reconciled */
+			if (node && node->stale)
+				changed = 1;
+
+			/* group counts change without the notification changing */
+			if (node && node->render && !changed)
+				changed = __noti_count_changed(node->render,
+								noti);
+		}
+
+		if (changed)
+			quickpanel_noti_node_set_render(node, NULL);
+
+		if (it && cur && it == cur->data) {
+			/* inserted ones go before the item kept in place */
+			prev = _quickpanel_noti_section_flush(list, parent,
+					prev, batch);
+			node->noti = noti;
+
+			if (changed) {
+				elm_genlist_item_fields_update(it, "*",
+						ELM_GENLIST_ITEM_FIELD_ALL);
+				n_updated++;
+			} else {
+				n_kept++;
 			}
-			head = notification_list_get_next(head);
+
+			cur = cur->next;
+		} else {
+			if (it) {
+				/*
+				 * may be in the other section, list_util
+				 * moves its anchors as the item goes
+				 */
+				g_hash_table_insert(moved, it, it);
+				elm_object_item_del(it);
+				n_moved++;
+			} else {
+				n_inserted++;
+			}
+
+			node = quickpanel_noti_node_add(entry->key, noti);
+			if (!node)
+				continue;
+
+			/* aggregates have no notification to build from */
+			if (!noti && _quickpanel_noti_node_set_more(node, entry))
+				quickpanel_noti_node_set_render(node, NULL);
+
+			qid = quickpanel_list_util_item_new(item_type, node);
+			if (!qid)
+				continue;
+
+			node->stale = 0;
+
+			/* runs of new items are inserted at once */
+			memset(&batch_entry, 0x00, sizeof(batch_entry));
+			batch_entry.itc = itc;
+			batch_entry.qid = qid;
+			batch_entry.type = ELM_GENLIST_ITEM_NONE;
+			batch_entry.func = quickpanel_noti_select_cb;
+			batch_entry.func_data = select_data;
+			g_array_append_val(batch, batch_entry);
+			continue;
 		}
 
-		notification_free_list(g_notification_ongoing_list);
-		g_notification_ongoing_list = new_noti_list;
-	} else {
-		g_notification_ongoing_list = new_noti_list;
+		node->stale = 0;
+		prev = it;
 	}
 
-	/* Get noti list */
-	notification_get_grouping_list(NOTIFICATION_TYPE_NOTI, -1,
-				       &new_noti_list);
-	if (g_notification_list != NULL) {
-		notification_free_list(g_notification_list);
-		g_notification_list = new_noti_list;
+	_quickpanel_noti_section_flush(list, parent, prev, batch);
+	g_array_free(batch, TRUE);
+
+	g_list_free(survivors);
+	g_hash_table_destroy(moved);
+	g_hash_table_destroy(desired);
+
+	DBG("type[%d] kept[%d] updated[%d] inserted[%d] moved[%d] removed[%d]",
+		item_type, n_kept, n_updated, n_inserted, n_moved, n_removed);
+
+	return n_updated + n_inserted + n_moved + n_removed;
+}
+
+static void _quickpanel_noti_shown_item_free(gpointer data)
+{
+	qp_noti_shown_item *entry = data;
+
+	if (!entry)
+		return;
+
+	free(entry->key);
+	free(entry->label);
+	free(entry->icon_path);
+	free(entry);
+}
+
+static qp_noti_shown_item *_quickpanel_noti_shown_item_new(const char *key,
+						notification_h noti)
+{
+	qp_noti_shown_item *entry = NULL;
+
+	entry = calloc(1, sizeof(qp_noti_shown_item));
+	retif(entry == NULL, NULL, "fail to alloc entry");
+
+	entry->key = strdup(key);
+	if (!entry->key) {
+		free(entry);
+		return NULL;
 	}
+	entry->noti = noti;
+
+	return entry;
+}
+
+static qp_noti_shown_item *_quickpanel_noti_shown_more_new(
+						const char *pkgname,
+						notification_h noti)
+{
+	qp_noti_shown_item *entry = NULL;
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	char *domain = NULL;
+	char *dir = NULL;
+	char *icon_path = NULL;
+
+	if (snprintf(buf, sizeof(buf), "%s"QP_NOTI_MORE_SUFFIX, pkgname) <= 0)
+		return NULL;
+
+	entry = _quickpanel_noti_shown_item_new(buf, NULL);
+	retif(entry == NULL, NULL, "fail to alloc entry");
+
+	/* app is named by the title its notifications are shown with */
+	notification_get_text_domain(noti, &domain, &dir);
+	if (domain != NULL && dir != NULL)
+		bindtextdomain(domain, dir);
+
+	entry->label = __noti_text_dup(noti, NOTIFICATION_TEXT_TYPE_TITLE);
+	if (!entry->label)
+		entry->label = strdup(pkgname);
+
+	/* aggregate shows the icon of the newest notification of the app */
+	notification_get_image(noti, NOTIFICATION_IMAGE_TYPE_ICON, &icon_path);
+	if (icon_path)
+		entry->icon_path = strdup(icon_path);
 
-	g_notification_list = new_noti_list;
+	return entry;
 }
 
-static void _quickpanel_noti_get_new_list(void)
+/* notifications under the group title, as the store counts them */
+static int _quickpanel_noti_group_count(struct appdata *ad)
 {
-	notification_list_h new_noti_list = NULL;
-	notification_list_h head = NULL;
-	notification_list_h new_head = NULL;
-	notification_h noti = NULL;
-	notification_h new_noti = NULL;
-	notification_type_e new_type = NOTIFICATION_TYPE_NONE;
-
-	if (g_notification_ongoing_list != NULL) {
-		notification_free_list(g_notification_ongoing_list);
-		g_notification_ongoing_list = new_noti_list;
-	}
+	notification_type_e type = NOTIFICATION_TYPE_NONE;
 
-	/* Get all list */
-	notification_get_grouping_list(NOTIFICATION_TYPE_NONE, -1,
-				       &new_noti_list);
-	if (g_notification_list != NULL) {
-		head = notification_list_get_head(g_notification_list);
-		while (head != NULL) {
-			new_head = notification_list_get_head(new_noti_list);
-			while (new_head != NULL) {
-				noti = notification_list_get_data(head);
-				new_noti = notification_list_get_data(new_head);
-
-				notification_get_type(new_noti, &new_type);
-
-				if (new_type == NOTIFICATION_TYPE_ONGOING)
-					__ongoing_comp_n_copy(noti, new_noti);
-
-				new_head = notification_list_get_next(new_head);
-			}
-			head = notification_list_get_next(head);
-		}
+	if (ad->show_setting)
+		type = NOTIFICATION_TYPE_NOTI;
 
-		notification_free_list(g_notification_list);
-		g_notification_list = new_noti_list;
-	} else {
-		g_notification_list = new_noti_list;
-	}
+	return quickpanel_noti_db_get_total(type);
 }
 
-static void _quickpanel_noti_clear_ongoinglist(Evas_Object *list)
+static void _quickpanel_noti_more_add(void *data, const char *pkgname,
+				const qp_noti_db_app *app)
 {
-	if (!list)
+	qp_noti_more_ctx *ctx = data;
+	qp_noti_shown_item *entry = NULL;
+	int more = 0;
+
+	more = app->count - GPOINTER_TO_INT(g_hash_table_lookup(ctx->per_app,
+								pkgname));
+	if (more <= 0)
 		return;
 
-	if (!ongoing_first)
+	entry = _quickpanel_noti_shown_more_new(pkgname, app->latest);
+	if (!entry)
 		return;
 
-	quickpanel_list_util_item_del_by_type(list, ongoing_first,
-			QP_ITEM_TYPE_ONGOING_NOTI);
+	entry->more = more;
+	entry->order = app->order;
+	g_ptr_array_add(ctx->more, entry);
 }
 
-static void _quickpanel_noti_clear_notilist(Evas_Object *list)
+static gint _quickpanel_noti_more_compare(gconstpointer a, gconstpointer b)
 {
-	if (!list)
-		return;
-
-	if (!noti_first)
-		return;
+	const qp_noti_shown_item *entry_a = *(qp_noti_shown_item * const *)a;
+	const qp_noti_shown_item *entry_b = *(qp_noti_shown_item * const *)b;
 
-	quickpanel_list_util_item_del_by_type(list, noti_first,
-			QP_ITEM_TYPE_NOTI);
+	return entry_a->order - entry_b->order;
 }
 
-static void _quickpanel_noti_clear_list_all(Evas_Object *list)
+/* an expanded app folds back once it fits under the per app cap again */
+static gboolean _quickpanel_noti_expanded_fits(gpointer key, gpointer value,
+						gpointer user_data)
 {
-	_quickpanel_noti_clear_ongoinglist(list);
-	ongoing_first = NULL;
+	notification_type_e type = GPOINTER_TO_INT(user_data);
+	const qp_noti_db_app *app = NULL;
 
-	if (noti_group) {
-		_quickpanel_noti_clear_notilist(list);
-		noti_first = NULL;
+	app = quickpanel_noti_db_get_app(type, key);
 
-		elm_object_item_del(noti_group);
-		noti_group = NULL;
-		quickpanel_list_util_del_count_by_itemtype(QP_ITEM_TYPE_NOTI_GROUP);
-	}
+	return (!app || app->count <= g_noti_max_per_app) ? TRUE : FALSE;
 }
 
-static void _quickpanel_noti_ongoing_add(Evas_Object *list, void *data)
+/*
+ * notifications of the list shown on the tray, in list order.
+ * When capped, notifications over the per app or the global limit are
+ * collapsed into one aggregate per app, appended after the others.
+ * Aggregate counts come from the per app counts of the mirror, the list is
+ * only walked until the global limit is reached.
+ */
+static GPtrArray *_quickpanel_noti_get_shown(notification_list_h noti_list,
+					notification_type_e type,
+					int is_capped)
 {
-	qp_item_data *qid = NULL;
-	Elm_Object_Item *it = NULL;
-
-	if (!list)
-		return;
-
-	qid = quickpanel_list_util_item_new(QP_ITEM_TYPE_ONGOING_NOTI, data);
-	if (!qid)
-		return;
+	GPtrArray *shown = NULL;
+	qp_noti_more_ctx ctx = { NULL, NULL };
+	qp_noti_shown_item *entry = NULL;
+	notification_list_h get_list = NULL;
+	notification_h noti = NULL;
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	char *key = NULL;
+	char *pkgname = NULL;
+	int app_count = 0;
+	int app_limit = 0;
+	guint i = 0;
+
+	shown = g_ptr_array_new_with_free_func(
+			_quickpanel_noti_shown_item_free);
+
+	/* pkgname strings belong to the notifications of the list */
+	if (is_capped) {
+		ctx.more = g_ptr_array_new();
+		ctx.per_app = g_hash_table_new(g_str_hash, g_str_equal);
+
+		if (g_noti_expanded)
+			g_hash_table_foreach_remove(g_noti_expanded,
+					_quickpanel_noti_expanded_fits,
+					GINT_TO_POINTER(type));
+	}
 
-	it = quickpanel_list_util_sort_insert(list, itc_ongoing, qid, NULL,
-			ELM_GENLIST_ITEM_NONE, quickpanel_noti_select_cb, data);
+	get_list = notification_list_get_head(noti_list);
+	while (get_list != NULL) {
+		if (is_capped && (int)shown->len >= g_noti_max_items)
+			break;
 
-	if (it)
-		ongoing_first = it;
-	else
-		ERR("fail to insert item to list : %p", data);
+		noti = notification_list_get_data(get_list);
+		get_list = notification_list_get_next(get_list);
 
-	DBG("noti ongoing[%p] data[%p] added, it[%p]", qid, data, it);
-}
+		if (!__noti_is_displayed(noti))
+			continue;
 
-static void _quickpanel_noti_group_add(Evas_Object *list, void *data)
-{
-	qp_item_data *qid = NULL;
-	Elm_Object_Item *it = NULL;
+		key = quickpanel_noti_node_make_key(noti, buf, sizeof(buf));
+		if (!key)
+			continue;
 
-	if (!list)
-		return;
+		if (!is_capped) {
+			entry = _quickpanel_noti_shown_item_new(key, noti);
+			if (entry)
+				g_ptr_array_add(shown, entry);
+			continue;
+		}
 
-	qid = quickpanel_list_util_item_new(QP_ITEM_TYPE_NOTI_GROUP, data);
-	if (!qid)
-		return;
+		pkgname = NULL;
+		notification_get_pkgname(noti, &pkgname);
+		if (!pkgname)
+			continue;
 
-	it = quickpanel_list_util_sort_insert(list, g_itc, qid, NULL,
-		ELM_GENLIST_ITEM_GROUP, NULL, NULL);
+		app_count = GPOINTER_TO_INT(g_hash_table_lookup(ctx.per_app,
+								pkgname));
+		if (g_noti_expanded && g_hash_table_lookup(g_noti_expanded,
+								pkgname))
+			app_limit = g_noti_max_items;
+		else
+			app_limit = g_noti_max_per_app;
 
-	if (it)
-		noti_group = it;
-	else
-		ERR("fail to insert item to list : %p", data);
+		/* the rest of the app is counted by its aggregate */
+		if (app_count >= app_limit)
+			continue;
 
-	DBG("noti group[%p] data[%p] added, it[%p]", qid, data, it);
-}
+		entry = _quickpanel_noti_shown_item_new(key, noti);
+		if (entry) {
+			g_ptr_array_add(shown, entry);
+			g_hash_table_insert(ctx.per_app, pkgname,
+					GINT_TO_POINTER(app_count + 1));
+		}
+	}
 
-static void _quickpanel_noti_noti_add(Evas_Object *list, void *data)
-{
-	qp_item_data *qid = NULL;
-	Elm_Object_Item *it = NULL;
+	if (is_capped) {
+		quickpanel_noti_db_foreach_app(type,
+				_quickpanel_noti_more_add, &ctx);
+		g_ptr_array_sort(ctx.more, _quickpanel_noti_more_compare);
 
-	if (!list)
-		return;
+		for (i = 0; i < ctx.more->len; i++)
+			g_ptr_array_add(shown, g_ptr_array_index(ctx.more, i));
 
-	qid = quickpanel_list_util_item_new(QP_ITEM_TYPE_NOTI, data);
-	if (!qid)
-		return;
+		DBG("shown[%d] aggregates[%d]", shown->len - ctx.more->len,
+			ctx.more->len);
 
-	if (!noti_group)
-		_quickpanel_noti_group_add(list, data);
+		g_ptr_array_free(ctx.more, TRUE);
+		g_hash_table_destroy(ctx.per_app);
+	}
 
-	it = quickpanel_list_util_sort_insert(list, itc_noti, qid, noti_group,
-		ELM_GENLIST_ITEM_NONE, quickpanel_noti_select_cb, data);
+	return shown;
+}
 
-	if (it)
-		noti_first = it;
-	else
-		ERR("fail to insert item to list : %p", data);
+static void _quickpanel_noti_rebuild_cancel(void)
+{
+	if (g_rebuild_timer) {
+		ecore_timer_del(g_rebuild_timer);
+		g_rebuild_timer = NULL;
+	}
 
-	DBG("noti[%p] data[%p] added, it[%p]", qid, data, it);
+	if (g_rebuild_idler) {
+		ecore_idler_del(g_rebuild_idler);
+		g_rebuild_idler = NULL;
+	}
 }
 
-
 void _quickpanel_noti_update_notilist(struct appdata *ad)
 {
 	Evas_Object *list = NULL;
-	notification_h noti = NULL;
-	notification_list_h get_list = NULL;
-	int applist = NOTIFICATION_DISPLAY_APP_ALL;
+	GPtrArray *ongoing_shown = NULL;
+	GPtrArray *noti_shown = NULL;
+	int group_count = 0;
+	int count_changed = 0;
+	int changed = 0;
 
 	DBG("");
 
@@ -1402,53 +2272,132 @@ void _quickpanel_noti_update_notilist(struct appdata *ad)
 	list = ad->list;
 	retif(list == NULL, , "Failed to get noti genlist.");
 
-	/* Clear genlist */
-	_quickpanel_noti_clear_list_all(list);
+	_quickpanel_noti_rebuild_cancel();
+	g_list_dirty = 0;
 
 	/* Update notification list */
 	if (ad->show_setting)
-		_quickpanel_noti_get_new_divided_list();
+		_quickpanel_noti_get_new_divided_list(ad);
 	else
-		_quickpanel_noti_get_new_list();
-
-	/* append ongoing data to genlist */
-	if (g_notification_ongoing_list) {
-		get_list =
-		    notification_list_get_tail(g_notification_ongoing_list);
-		noti = notification_list_get_data(get_list);
-
-		while (get_list != NULL) {
-			notification_get_display_applist(noti, &applist);
+		_quickpanel_noti_get_new_list(ad);
+
+	/* progress of ongoing items must stay visible, they are not capped */
+	ongoing_shown = _quickpanel_noti_get_shown(g_notification_ongoing_list,
+						NOTIFICATION_TYPE_ONGOING, 0);
+	noti_shown = _quickpanel_noti_get_shown(g_notification_list,
+			ad->show_setting ? NOTIFICATION_TYPE_NOTI :
+			NOTIFICATION_TYPE_NONE, 1);
+
+	/* reconcile ongoing items */
+	changed += _quickpanel_noti_section_update(list,
+			ongoing_shown, QP_ITEM_TYPE_ONGOING_NOTI,
+			itc_ongoing, NULL, ad);
+
+	/* set before the group title can be realized */
+	group_count = _quickpanel_noti_group_count(ad);
+	if (group_count != g_noti_group_count) {
+		DBG("group count %d -> %d", g_noti_group_count, group_count);
+
+		g_noti_group_count = group_count;
+		count_changed = 1;
+	}
 
-			if (applist &
-			    NOTIFICATION_DISPLAY_APP_NOTIFICATION_TRAY)
-				_quickpanel_noti_ongoing_add(list, noti);
+	/* reconcile noti items under the group title */
+	if (noti_shown->len > 0) {
+		if (!noti_group)
+			_quickpanel_noti_group_add(list, ad);
 
-			get_list = notification_list_get_prev(get_list);
-			noti = notification_list_get_data(get_list);
-		}
+		changed += _quickpanel_noti_section_update(list,
+				noti_shown, QP_ITEM_TYPE_NOTI,
+				itc_noti, noti_group, ad);
+	} else if (noti_group) {
+		_quickpanel_noti_clear_group(list);
 	}
 
-	/* append noti data to genlist */
-	if (g_notification_list) {
-		get_list = notification_list_get_tail(g_notification_list);
-		noti = notification_list_get_data(get_list);
+	g_ptr_array_free(ongoing_shown, TRUE);
+	g_ptr_array_free(noti_shown, TRUE);
 
-		while (get_list != NULL) {
-			notification_get_display_applist(noti, &applist);
+	/* index the new lists, nothing refers to the previous ones anymore */
+	quickpanel_noti_node_sync(g_notification_ongoing_list,
+				g_notification_list);
 
-			if (applist &
-			    NOTIFICATION_DISPLAY_APP_NOTIFICATION_TRAY)
-				_quickpanel_noti_noti_add(list, noti);
+	/* header is only touched when its count moves */
+	if (count_changed && noti_group)
+		elm_genlist_item_fields_update(noti_group, "elm.text.text",
+				ELM_GENLIST_ITEM_FIELD_TEXT);
 
-			get_list = notification_list_get_prev(get_list);
-			noti = notification_list_get_data(get_list);
-		}
-	}
+	DBG("%d items touched", changed);
 
 	quickpanel_ui_update_height(ad);
 }
 
+static Eina_Bool _quickpanel_noti_rebuild_idler_cb(void *data)
+{
+	g_rebuild_idler = NULL;
+
+	if (g_list_dirty)
+		_quickpanel_noti_update_notilist(data);
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static Eina_Bool _quickpanel_noti_rebuild_timer_cb(void *data)
+{
+	g_rebuild_timer = NULL;
+
+	if (!g_rebuild_idler)
+		g_rebuild_idler = ecore_idler_add(
+				_quickpanel_noti_rebuild_idler_cb, data);
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void _quickpanel_noti_rebuild_schedule(struct appdata *ad)
+{
+	if (suspended)
+		return;
+
+	if (g_rebuild_timer)
+		ecore_timer_reset(g_rebuild_timer);
+	else if (!g_rebuild_idler)
+		g_rebuild_timer = ecore_timer_add(QP_NOTI_REBUILD_DELAY,
+				_quickpanel_noti_rebuild_timer_cb, ad);
+}
+
+/*
+ * list changed while the panel is closed or the app is paused.
+ * Nodes are moved to the new lists at once since the mirror releases the
+ * previous ones, items are reconciled when the panel opens or once the
+ * changes settle down.
+ */
+static void _quickpanel_noti_update_deferred(struct appdata *ad)
+{
+	retif(ad == NULL, , "Invalid parameter!");
+
+	if (ad->show_setting)
+		_quickpanel_noti_get_new_divided_list(ad);
+	else
+		_quickpanel_noti_get_new_list(ad);
+
+	quickpanel_noti_node_sync(g_notification_ongoing_list,
+				g_notification_list);
+
+	g_list_dirty = 1;
+
+	_quickpanel_noti_rebuild_schedule(ad);
+}
+
+
+static void _quickpanel_noti_update_request(struct appdata *ad)
+{
+	retif(ad == NULL, , "Invalid parameter!");
+
+	if (QP_IS_OPENED(ad) && !suspended)
+		_quickpanel_noti_update_notilist(ad);
+	else
+		_quickpanel_noti_update_deferred(ad);
+}
+
 static void _quickpanel_noti_delete_volatil_data(void)
 {
 	notification_list_h noti_list = NULL;
@@ -1479,9 +2428,11 @@ static void _quickpanel_noti_delete_volatil_data(void)
 	notification_update(NULL);
 }
 
-static void _quickpanel_noti_changed_cb(void *data, notification_type_e type)
+static void _quickpanel_noti_db_changed_cb(void *data,
+					notification_type_e type,
+					const qp_noti_db_delta *delta)
 {
-	_quickpanel_noti_update_notilist(data);
+	_quickpanel_noti_update_request(data);
 }
 
 static void _quickpanel_noti_update_sim_status_cb(keynode_t *node, void *data)
@@ -1489,7 +2440,7 @@ static void _quickpanel_noti_update_sim_status_cb(keynode_t *node, void *data)
 	struct appdata *ad = data;
 
 	if (ad != NULL && ad->list != NULL)
-		_quickpanel_noti_update_notilist(ad);
+		_quickpanel_noti_update_request(ad);
 }
 
 static int _quickpanel_noti_register_event_handler(struct appdata *ad)
@@ -1539,8 +2490,13 @@ static int _quickpanel_noti_register_event_handler(struct appdata *ad)
 	if (ret != 0)
 		ERR("Failed to register SIM_SLOT change callback!");
 
+	/* Track realized progressbars of ongoing items */
+	if (ad->list)
+		evas_object_smart_callback_add(ad->list, "unrealized",
+				_quickpanel_noti_gl_unrealized_cb, ad);
+
 	/* Register notification changed cb */
-	notification_resister_changed_cb(_quickpanel_noti_changed_cb, ad);
+	quickpanel_noti_db_add_listener(_quickpanel_noti_db_changed_cb, ad);
 
 	return ret;
 }
@@ -1550,7 +2506,11 @@ static int _quickpanel_noti_unregister_event_handler(struct appdata *ad)
 	int ret = 0;
 
 	/* Unregister notification changed cb */
-	notification_unresister_changed_cb(_quickpanel_noti_changed_cb);
+	quickpanel_noti_db_del_listener(_quickpanel_noti_db_changed_cb, ad);
+
+	if (ad->list)
+		evas_object_smart_callback_del(ad->list, "unrealized",
+				_quickpanel_noti_gl_unrealized_cb);
 
 	/* Ignore vconf key */
 	ret = vconf_ignore_key_changed(VCONFKEY_TELEPHONY_SIM_SLOT,
@@ -1602,6 +2562,61 @@ static int _quickpanel_noti_check_first_start(void)
 	return 1;
 }
 
+static void _quickpanel_noti_time_timer_start(void *data);
+
+static void _quickpanel_noti_time_refresh(struct appdata *ad)
+{
+	Eina_List *realized = NULL;
+	Elm_Object_Item *it = NULL;
+	qp_item_data *qid = NULL;
+
+	retif(ad == NULL || ad->list == NULL, , "Invalid parameter!");
+
+	/* unrealized items rebuild their snapshot when shown again */
+	quickpanel_noti_node_reset_render();
+
+	realized = elm_genlist_realized_items_get(ad->list);
+	EINA_LIST_FREE(realized, it) {
+		qid = elm_object_item_data_get(it);
+		if (qid && quickpanel_list_util_item_get_type(qid)
+				== QP_ITEM_TYPE_NOTI)
+			elm_genlist_item_fields_update(it, "elm.text.time",
+					ELM_GENLIST_ITEM_FIELD_TEXT);
+	}
+}
+
+static Eina_Bool _quickpanel_noti_time_timer_cb(void *data)
+{
+	g_time_timer = NULL;
+
+	if (_quickpanel_noti_time_info_update())
+		_quickpanel_noti_time_refresh(data);
+
+	_quickpanel_noti_time_timer_start(data);
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void _quickpanel_noti_time_timer_start(void *data)
+{
+	time_t now = time(NULL);
+
+	if (g_time_timer)
+		ecore_timer_del(g_time_timer);
+
+	/* wake up on the next minute, midnight is on a minute too */
+	g_time_timer = ecore_timer_add(60 - (now % 60),
+			_quickpanel_noti_time_timer_cb, data);
+}
+
+static void _quickpanel_noti_time_timer_stop(void)
+{
+	if (g_time_timer) {
+		ecore_timer_del(g_time_timer);
+		g_time_timer = NULL;
+	}
+}
+
 static int quickpanel_noti_init(void *data)
 {
 	struct appdata *ad = data;
@@ -1620,12 +2635,23 @@ static int quickpanel_noti_init(void *data)
 
 	_quickpanel_noti_gl_style_init();
 
+	quickpanel_noti_node_init();
+	quickpanel_noti_db_init();
+	_quickpanel_noti_update_init();
+
+	quickpanel_noti_pool_init(ad->list);
+	quickpanel_noti_pool_set_rows(_quickpanel_noti_get_first_page(ad));
+
 	/* Register event handler */
 	_quickpanel_noti_register_event_handler(ad);
 
+	_quickpanel_noti_time_info_update();
+
 	/* Update notification list */
 	_quickpanel_noti_update_notilist(ad);
 
+	/* panel starts closed, the time timer runs while it is open */
+
 	return QP_OK;
 }
 
@@ -1634,26 +2660,42 @@ static int quickpanel_noti_fini(void *data)
 	struct appdata *ad = data;
 	retif(ad == NULL, QP_FAIL, "Invalid parameter!");
 
-	/* Remove notification list */
-	if (g_notification_ongoing_list != NULL) {
-		notification_free_list(g_notification_ongoing_list);
+	/* Unregister event handler */
+	_quickpanel_noti_unregister_event_handler(data);
 
-		g_notification_ongoing_list = NULL;
-	}
+	_quickpanel_noti_update_fini();
+	_quickpanel_noti_rebuild_cancel();
+	g_list_dirty = 0;
+
+	_quickpanel_noti_clear_list_all(ad->list);
+	g_noti_group_count = 0;
 
-	if (g_notification_list != NULL) {
-		notification_free_list(g_notification_list);
+	/* items are gone, their contents were released to the pool */
+	quickpanel_noti_pool_fini();
 
-		g_notification_list = NULL;
+	if (g_clear_button) {
+		evas_object_unref(g_clear_button);
+		evas_object_del(g_clear_button);
+		g_clear_button = NULL;
 	}
 
-	/* Unregister event handler */
-	_quickpanel_noti_unregister_event_handler(data);
+	quickpanel_noti_node_fini();
 
-	_quickpanel_noti_clear_list_all(ad->list);
+	/* Remove notification list */
+	g_notification_ongoing_list = NULL;
+	g_notification_list = NULL;
+	quickpanel_noti_db_fini();
 
 	_quickpanel_noti_gl_style_fini();
 
+	_quickpanel_noti_time_timer_stop();
+	_quickpanel_noti_date_formatter_reset();
+
+	if (g_noti_expanded) {
+		g_hash_table_destroy(g_noti_expanded);
+		g_noti_expanded = NULL;
+	}
+
 	return QP_OK;
 }
 
@@ -1661,6 +2703,9 @@ static int quickpanel_noti_suspend(void *data)
 {
 	suspended = 1;
 
+	_quickpanel_noti_time_timer_stop();
+	_quickpanel_noti_rebuild_cancel();
+
 	return QP_OK;
 }
 
@@ -1671,35 +2716,254 @@ static int quickpanel_noti_resume(void *data)
 
 	suspended = 0;
 
+	/* changes came while paused */
+	if (g_list_dirty) {
+		if (QP_IS_OPENED(ad))
+			_quickpanel_noti_update_notilist(ad);
+		else
+			_quickpanel_noti_rebuild_schedule(ad);
+	}
+
 	if (ad->list)
 		quickpanel_list_util_item_update_by_type(ad->list,
-				ongoing_first, QP_ITEM_TYPE_ONGOING_NOTI);
+				NULL, QP_ITEM_TYPE_ONGOING_NOTI);
+
+	/* time labels are only kept up to date while the panel is open */
+	if (QP_IS_OPENED(ad)) {
+		/* day may have changed while the timer was stopped */
+		if (_quickpanel_noti_time_info_update())
+			_quickpanel_noti_time_refresh(ad);
+
+		_quickpanel_noti_time_timer_start(ad);
+	}
 
 	return QP_OK;
 }
 
+static void quickpanel_noti_visibility_changed(void *data,
+					qp_visibility_e state)
+{
+	struct appdata *ad = data;
+
+	retif(ad == NULL, , "Invalid parameter!");
+
+	switch (state) {
+	case QP_VISIBILITY_OPENING:
+		/* rows on screen follow the rotation */
+		quickpanel_noti_pool_set_rows(
+				_quickpanel_noti_get_first_page(ad));
+
+		if (g_list_dirty)
+			_quickpanel_noti_update_notilist(ad);
+
+		if (suspended)
+			break;
+
+		if (_quickpanel_noti_time_info_update())
+			_quickpanel_noti_time_refresh(ad);
+
+		_quickpanel_noti_time_timer_start(ad);
+		break;
+	case QP_VISIBILITY_HIDDEN:
+		_quickpanel_noti_time_timer_stop();
+		break;
+	default:
+		break;
+	}
+}
+
 void quickpanel_noti_lang_changed(void *data)
 {
 	struct appdata *ad = data;
 
 	retif(ad == NULL, , "Invalid parameter!");
 
+	/* texts are resolved for the previous language */
+	_quickpanel_noti_date_formatter_reset();
+	quickpanel_noti_node_reset_render();
+
 	_quickpanel_noti_update_notilist(ad);
+
+	if (ad->list) {
+		quickpanel_list_util_item_update_by_type(ad->list,
+				NULL, QP_ITEM_TYPE_ONGOING_NOTI);
+		quickpanel_list_util_item_update_by_type(ad->list,
+				NULL, QP_ITEM_TYPE_NOTI);
+	}
+
+	/* count is the same, the header format is not */
+	if (noti_group)
+		elm_genlist_item_fields_update(noti_group, "elm.text.text",
+				ELM_GENLIST_ITEM_FIELD_TEXT);
+
+	/* button is cached across header realizes */
+	if (g_clear_button)
+		elm_object_text_set(g_clear_button, _S("IDS_COM_POP_CLEAR"));
 }
 
-static int quickpanel_noti_get_height(void *data)
+static void quickpanel_noti_region_changed(void *data)
 {
-	int height = 0;
 	struct appdata *ad = data;
 
-	retif(ad == NULL, 0, "Invalid parameter!");
+	retif(ad == NULL, , "Invalid parameter!");
+
+	/* dates are formatted for the previous region */
+	_quickpanel_noti_date_formatter_reset();
+	quickpanel_noti_node_reset_render();
+
+	if (ad->list)
+		quickpanel_list_util_item_update_by_type(ad->list,
+				NULL, QP_ITEM_TYPE_NOTI);
+}
+
+static int quickpanel_noti_get_height(void *data)
+{
+	retif(data == NULL, 0, "Invalid parameter!");
+
+	return quickpanel_list_util_get_height(QP_ITEM_TYPE_ONGOING_NOTI)
+		+ quickpanel_list_util_get_height(QP_ITEM_TYPE_NOTI_GROUP)
+		+ quickpanel_list_util_get_height(QP_ITEM_TYPE_NOTI);
+}
+
+#ifdef QP_SELFTEST
+static notification_list_h __bench_list_new(GPtrArray *notis)
+{
+	notification_list_h noti_list = NULL;
+	guint i = 0;
+
+	for (i = 0; i < notis->len; i++)
+		noti_list = notification_list_append(noti_list,
+				g_ptr_array_index(notis, i));
+
+	return notification_list_get_head(noti_list);
+}
+
+/* the notifications belong to the bench, only the nodes are released */
+static void __bench_list_free(notification_list_h noti_list)
+{
+	noti_list = notification_list_get_head(noti_list);
+	while (noti_list != NULL)
+		noti_list = notification_list_remove(noti_list,
+				notification_list_get_data(noti_list));
+}
+
+static notification_h __bench_noti_new(int index)
+{
+	notification_h noti = NULL;
+	char buf[64] = { 0, };
+
+	noti = notification_create(NOTIFICATION_TYPE_NOTI);
+	retif(noti == NULL, NULL, "fail to create notification");
+
+	snprintf(buf, sizeof(buf), "org.tizen.qpbench%d", index);
+	notification_set_pkgname(noti, buf);
+	notification_set_text(noti, NOTIFICATION_TEXT_TYPE_TITLE, buf,
+				NULL, NOTIFICATION_VARIABLE_TYPE_NONE);
+
+	return noti;
+}
+
+static int __bench_section_update(Evas_Object *list,
+				Elm_Genlist_Item_Class *itc,
+				notification_list_h noti_list)
+{
+	GPtrArray *shown = NULL;
+	int touched = 0;
+
+	shown = _quickpanel_noti_get_shown(noti_list, NOTIFICATION_TYPE_NOTI,
+					0);
+	touched = _quickpanel_noti_section_update(list, shown,
+			QP_ITEM_TYPE_NOTI, itc, NULL, NULL);
+	g_ptr_array_free(shown, TRUE);
+
+	quickpanel_noti_node_sync(NULL, noti_list);
+
+	return touched;
+}
+
+void quickpanel_noti_bench_reconcile(Evas_Object *win, int count, int rounds)
+{
+	Evas_Object *list = NULL;
+	Elm_Genlist_Item_Class *itc = NULL;
+	notification_list_h noti_list = NULL;
+	notification_h noti = NULL;
+	GPtrArray *notis = NULL;
+	double start = 0.0;
+	double reconcile = 0.0;
+	double rebuild = 0.0;
+	int touched_reconcile = 0;
+	int touched_rebuild = 0;
+	int i = 0;
+
+	retif(win == NULL || count <= 0 || rounds <= 0, , "Invalid parameter!");
+	retif(quickpanel_list_util_get_first_item(QP_ITEM_TYPE_NOTI) != NULL, ,
+		"noti section is in use");
+
+	list = elm_genlist_add(win);
+	retif(list == NULL, , "fail to add list");
+
+	itc = elm_genlist_item_class_new();
+	if (!itc) {
+		ERR("fail to alloc itc");
+		evas_object_del(list);
+		return;
+	}
+
+	itc->item_style = "notification_item";
+	itc->func.del = _quickpanel_noti_gl_del;
+
+	quickpanel_noti_node_init();
+
+	notis = g_ptr_array_new_with_free_func(
+			(GDestroyNotify)notification_free);
+	for (i = 0; i < count; i++) {
+		noti = __bench_noti_new(i);
+		if (noti)
+			g_ptr_array_add(notis, noti);
+	}
+
+	noti_list = __bench_list_new(notis);
+	__bench_section_update(list, itc, noti_list);
+	__bench_list_free(noti_list);
 
-	qp_item_count *noti_item_count = quickpanel_list_util_get_item_count();
+	for (i = 0; i < rounds; i++) {
+		/* one incoming notification on top of the others */
+		noti = __bench_noti_new(count + i);
+		if (!noti)
+			break;
 
-	if (noti_item_count != NULL) {
-		height = noti_item_count->group*QP_THEME_LIST_ITEM_GROUP_HEIGHT
-				+ noti_item_count->noti*QP_THEME_LIST_ITEM_NOTI_HEIGHT
-				+ noti_item_count->ongoing*QP_THEME_LIST_ITEM_ONGOING_HEIGHT;
+		g_ptr_array_add(notis, noti);
+		memmove(notis->pdata + 1, notis->pdata,
+			(notis->len - 1) * sizeof(gpointer));
+		notis->pdata[0] = noti;
+
+		noti_list = __bench_list_new(notis);
+
+		start = ecore_time_get();
+		touched_reconcile += __bench_section_update(list, itc,
+							noti_list);
+		reconcile += ecore_time_get() - start;
+
+		/* what every change used to cost */
+		start = ecore_time_get();
+		quickpanel_list_util_item_del_by_type(list, NULL,
+				QP_ITEM_TYPE_NOTI);
+		touched_rebuild += __bench_section_update(list, itc,
+							noti_list);
+		rebuild += ecore_time_get() - start;
+
+		__bench_list_free(noti_list);
 	}
-	return height * ad->scale;
+
+	INFO("items[%d] rounds[%d] reconcile[%lf sec, %d touched] "
+		"rebuild[%lf sec, %d touched]", count, i, reconcile,
+		touched_reconcile, rebuild, touched_rebuild);
+
+	quickpanel_list_util_item_del_by_type(list, NULL, QP_ITEM_TYPE_NOTI);
+	quickpanel_noti_node_fini();
+
+	g_ptr_array_free(notis, TRUE);
+	elm_genlist_item_class_free(itc);
+	evas_object_del(list);
 }
+#endif /* QP_SELFTEST */
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QP_NOTI_H__
+#define __QP_NOTI_H__
+
+typedef struct _qp_noti_update_stats {
+	/* progress/size/content signals accepted */
+	unsigned int received;
+	/* signals merged into an update already pending */
+	unsigned int coalesced;
+	/* updates written to the notifications */
+	unsigned int applied;
+	/* animator flushes */
+	unsigned int frames;
+} qp_noti_update_stats;
+
+void quickpanel_noti_get_update_stats(qp_noti_update_stats *stats);
+
+/*
+ * caps of the notification section, notifications over them are
+ * collapsed into one "N more" item per app. zero or less keeps a cap.
+ */
+void quickpanel_noti_set_limit(int max_items, int max_per_app);
+
+#ifdef QP_SELFTEST
+#include <Elementary.h>
+
+/*
+ * logs the cost of one new notification on top of count shown ones,
+ * reconciled and cleared and rebuilt, on a genlist added to win and
+ * never shown. must run before the noti module fills its section.
+ */
+void quickpanel_noti_bench_reconcile(Evas_Object *win, int count, int rounds);
+#endif /* QP_SELFTEST */
+
+#endif /* __QP_NOTI_H__ */
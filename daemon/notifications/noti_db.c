@@ -0,0 +1,688 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <Ecore.h>
+#include <Eina.h>
+#include <notification.h>
+
+#include "common.h"
+#include "noti_node.h"
+#include "noti_db.h"
+
+/* slot 0 mirrors NOTIFICATION_TYPE_NONE, the list of every type */
+#define QP_NOTI_DB_SLOT(type)	((type) + 1)
+#define QP_NOTI_DB_TYPE(slot)	((notification_type_e)((slot) - 1))
+#define QP_NOTI_DB_SLOT_MAX	(NOTIFICATION_TYPE_MAX + 1)
+
+typedef struct _noti_db_slot {
+	/*
+	 * whole list of the type once the rest of a partial read came in,
+	 * the store has no per app count to bound it to the shown page
+	 */
+	notification_list_h list;
+	/* read once somebody asked for it */
+	int active;
+	/* store changed since the last read */
+	int dirty;
+	/* only the head of the list was read */
+	int partial;
+	/* "pkgname:group_id:priv_id" -> count */
+	GHashTable *counts;
+	/* pkgname -> qp_noti_db_app, follows list */
+	GHashTable *apps;
+	/* notifications behind the entries of list, a group counts them all */
+	int total;
+} noti_db_slot;
+
+typedef struct _noti_db_listener {
+	qp_noti_db_changed_cb cb;
+	void *data;
+} noti_db_listener;
+
+static int g_db_ref;
+static noti_db_slot g_db_slots[QP_NOTI_DB_SLOT_MAX];
+
+/*
+ * key of every mirrored notification -> its first occurrence, to tell
+ * inserts from updates
+ */
+static GHashTable *g_db_index;
+static Eina_List *g_db_listeners;
+static Ecore_Idler *g_db_idler;
+
+static int g_db_changed_pending;
+static notification_type_e g_db_changed_type;
+
+static qp_noti_db_stats g_db_stats;
+
+static notification_error_e _noti_db_default_get_list(notification_type_e type,
+					int count, notification_list_h *list)
+{
+	return notification_get_grouping_list(type, count, list);
+}
+
+static notification_error_e _noti_db_default_free_list(
+					notification_list_h list)
+{
+	return notification_free_list(list);
+}
+
+static notification_error_e _noti_db_default_get_count(
+					notification_type_e type,
+					const char *pkgname, int group_id,
+					int priv_id, int *count)
+{
+	return notification_get_count(type, (char *)pkgname, group_id,
+					priv_id, count);
+}
+
+static const qp_noti_db_backend g_db_default_backend = {
+	.get_list = _noti_db_default_get_list,
+	.free_list = _noti_db_default_free_list,
+	.get_count = _noti_db_default_get_count,
+};
+
+static const qp_noti_db_backend *g_db_backend = &g_db_default_backend;
+
+static void _noti_db_index_list(GHashTable *index,
+				notification_list_h noti_list)
+{
+	notification_list_h get_list = NULL;
+	notification_h noti = NULL;
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	char *key = NULL;
+
+	get_list = notification_list_get_head(noti_list);
+	while (get_list != NULL) {
+		noti = notification_list_get_data(get_list);
+		get_list = notification_list_get_next(get_list);
+
+		key = quickpanel_noti_node_make_key(noti, buf, sizeof(buf));
+		if (!key)
+			continue;
+
+		if (g_hash_table_lookup(index, key))
+			continue;
+
+		key = strdup(key);
+		if (key)
+			g_hash_table_insert(index, key, noti);
+	}
+}
+
+static void _noti_db_index_apps(int index)
+{
+	noti_db_slot *slot = &g_db_slots[index];
+	notification_list_h get_list = NULL;
+	notification_h noti = NULL;
+	qp_noti_db_app *app = NULL;
+	char *pkgname = NULL;
+	char *key = NULL;
+	int applist = NOTIFICATION_DISPLAY_APP_ALL;
+	int group_id = 0, priv_id = 0, count = 0;
+
+	if (slot->apps)
+		g_hash_table_remove_all(slot->apps);
+	else
+		slot->apps = g_hash_table_new_full(g_str_hash, g_str_equal,
+					free, free);
+
+	slot->total = 0;
+
+	get_list = notification_list_get_head(slot->list);
+	while (get_list != NULL) {
+		noti = notification_list_get_data(get_list);
+		get_list = notification_list_get_next(get_list);
+
+		pkgname = NULL;
+		notification_get_pkgname(noti, &pkgname);
+
+		/* only a group is queried, its count is cached for the rows */
+		group_id = NOTIFICATION_GROUP_ID_NONE;
+		notification_get_id(noti, &group_id, &priv_id);
+		count = 1;
+		if (group_id != NOTIFICATION_GROUP_ID_NONE)
+			quickpanel_noti_db_get_count(QP_NOTI_DB_TYPE(index),
+					pkgname, group_id, priv_id, &count);
+		slot->total += count;
+
+		applist = NOTIFICATION_DISPLAY_APP_ALL;
+		notification_get_display_applist(noti, &applist);
+		if (!(applist & NOTIFICATION_DISPLAY_APP_NOTIFICATION_TRAY))
+			continue;
+
+		if (!pkgname)
+			continue;
+
+		app = g_hash_table_lookup(slot->apps, pkgname);
+		if (!app) {
+			app = calloc(1, sizeof(qp_noti_db_app));
+			key = strdup(pkgname);
+			if (!app || !key) {
+				free(app);
+				free(key);
+				continue;
+			}
+
+			app->latest = noti;
+			app->order = g_hash_table_size(slot->apps);
+			g_hash_table_insert(slot->apps, key, app);
+		}
+		app->count++;
+	}
+}
+
+static int _noti_db_read(int slot, int count)
+{
+	notification_list_h noti_list = NULL;
+	notification_error_e noti_err = NOTIFICATION_ERROR_NONE;
+
+	g_db_stats.reads++;
+
+	noti_err = g_db_backend->get_list(QP_NOTI_DB_TYPE(slot), count,
+					&noti_list);
+	if (noti_err != NOTIFICATION_ERROR_NONE) {
+		ERR("fail to read type[%d] : %d", QP_NOTI_DB_TYPE(slot),
+			noti_err);
+		return QP_FAIL;
+	}
+
+	g_db_slots[slot].list = noti_list;
+	g_db_slots[slot].dirty = 0;
+	g_db_slots[slot].partial = (count > 0) ? 1 : 0;
+
+	_noti_db_index_apps(slot);
+
+	return QP_OK;
+}
+
+static void _noti_db_notify(notification_type_e type,
+				const qp_noti_db_delta *delta)
+{
+	Eina_List *l = NULL;
+	Eina_List *l_next = NULL;
+	noti_db_listener *listener = NULL;
+
+	EINA_LIST_FOREACH_SAFE(g_db_listeners, l, l_next, listener) {
+		if (listener->cb)
+			listener->cb(listener->data, type, delta);
+	}
+}
+
+static void _noti_db_flush(void)
+{
+	notification_list_h old_list[QP_NOTI_DB_SLOT_MAX] = { NULL, };
+	notification_type_e type = g_db_changed_type;
+	int is_changed = g_db_changed_pending;
+	qp_noti_db_delta delta = { 0, };
+	GHashTableIter iter;
+	gpointer key = NULL;
+	GHashTable *index = NULL;
+	int i = 0;
+
+	g_db_changed_pending = 0;
+	g_db_stats.refreshes++;
+
+	for (i = 0; i < QP_NOTI_DB_SLOT_MAX; i++) {
+		if (!g_db_slots[i].active
+		    || (!g_db_slots[i].dirty && !g_db_slots[i].partial))
+			continue;
+
+		old_list[i] = g_db_slots[i].list;
+		g_db_slots[i].list = NULL;
+
+		/* keep the stale list, the slot stays dirty for the next try */
+		if (_noti_db_read(i, -1) != QP_OK) {
+			g_db_slots[i].list = old_list[i];
+			old_list[i] = NULL;
+		}
+	}
+
+	index = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+	for (i = 0; i < QP_NOTI_DB_SLOT_MAX; i++) {
+		if (g_db_slots[i].active)
+			_noti_db_index_list(index, g_db_slots[i].list);
+	}
+
+	g_hash_table_iter_init(&iter, index);
+	while (g_hash_table_iter_next(&iter, &key, NULL)) {
+		if (!g_db_index || !g_hash_table_lookup(g_db_index, key))
+			delta.inserted++;
+	}
+
+	if (g_db_index) {
+		g_hash_table_iter_init(&iter, g_db_index);
+		while (g_hash_table_iter_next(&iter, &key, NULL)) {
+			if (!g_hash_table_lookup(index, key))
+				delta.deleted++;
+		}
+		g_hash_table_destroy(g_db_index);
+	}
+	g_db_index = index;
+
+	/* rest of a partial read, nothing changed in the store */
+	if (!is_changed) {
+		type = NOTIFICATION_TYPE_NONE;
+		delta.inserted = 0;
+		delta.deleted = 0;
+	}
+	delta.changed = is_changed;
+
+	DBG("type[%d] inserted[%d] deleted[%d] reads[%u]", type,
+		delta.inserted, delta.deleted, g_db_stats.reads);
+
+	/* listeners may still refer to the previous lists */
+	_noti_db_notify(type, &delta);
+
+	for (i = 0; i < QP_NOTI_DB_SLOT_MAX; i++) {
+		if (old_list[i] != NULL)
+			g_db_backend->free_list(old_list[i]);
+	}
+}
+
+static Eina_Bool _noti_db_idler_cb(void *data)
+{
+	g_db_idler = NULL;
+
+	_noti_db_flush();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void _noti_db_schedule_flush(void)
+{
+	if (!g_db_idler)
+		g_db_idler = ecore_idler_add(_noti_db_idler_cb, NULL);
+}
+
+static void _noti_db_schedule(notification_type_e type)
+{
+	/* several types changed in one batch */
+	if (g_db_changed_pending && g_db_changed_type != type)
+		g_db_changed_type = NOTIFICATION_TYPE_NONE;
+	else
+		g_db_changed_type = type;
+
+	g_db_changed_pending = 1;
+
+	_noti_db_schedule_flush();
+}
+
+static void _noti_db_count_invalidate(int slot)
+{
+	if (g_db_slots[slot].counts)
+		g_hash_table_remove_all(g_db_slots[slot].counts);
+}
+
+notification_error_e quickpanel_noti_db_get_count(notification_type_e type,
+					const char *pkgname, int group_id,
+					int priv_id, int *count)
+{
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	notification_error_e noti_err = NOTIFICATION_ERROR_NONE;
+	noti_db_slot *slot = NULL;
+	gpointer value = NULL;
+	char *key = NULL;
+
+	retif(count == NULL, NOTIFICATION_ERROR_INVALID_DATA,
+		"Invalid parameter!");
+	retif(type < NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX,
+		NOTIFICATION_ERROR_INVALID_DATA, "Invalid parameter!");
+
+	slot = &g_db_slots[QP_NOTI_DB_SLOT(type)];
+
+	if (snprintf(buf, sizeof(buf), "%s:%d:%d", pkgname ? pkgname : "",
+			group_id, priv_id) <= 0)
+		return NOTIFICATION_ERROR_INVALID_DATA;
+
+	if (slot->counts
+	    && g_hash_table_lookup_extended(slot->counts, buf, NULL, &value)) {
+		g_db_stats.count_hits++;
+		*count = GPOINTER_TO_INT(value);
+		return NOTIFICATION_ERROR_NONE;
+	}
+
+	g_db_stats.count_misses++;
+
+	noti_err = g_db_backend->get_count(type, pkgname, group_id,
+					priv_id, count);
+	if (noti_err != NOTIFICATION_ERROR_NONE)
+		return noti_err;
+
+	/* not cached before init or after fini, nothing would drop it */
+	if (g_db_ref <= 0)
+		return noti_err;
+
+	if (!slot->counts)
+		slot->counts = g_hash_table_new_full(g_str_hash, g_str_equal,
+						free, NULL);
+
+	key = strdup(buf);
+	if (key)
+		g_hash_table_insert(slot->counts, key, GINT_TO_POINTER(*count));
+
+	return noti_err;
+}
+
+static void _noti_db_changed_cb(void *data, notification_type_e type)
+{
+	quickpanel_noti_db_changed(type);
+}
+
+void quickpanel_noti_db_changed(notification_type_e type)
+{
+	retif(g_db_ref <= 0, , "noti db is not initialized");
+
+	g_db_stats.changes++;
+
+	/* store does not tell which type changed, mirror is out of sync */
+	if (type <= NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX) {
+		quickpanel_noti_db_resync();
+		return;
+	}
+
+	g_db_slots[QP_NOTI_DB_SLOT(type)].dirty = 1;
+	g_db_slots[QP_NOTI_DB_SLOT(NOTIFICATION_TYPE_NONE)].dirty = 1;
+
+	/* counts of the other types are still valid */
+	_noti_db_count_invalidate(QP_NOTI_DB_SLOT(type));
+	_noti_db_count_invalidate(QP_NOTI_DB_SLOT(NOTIFICATION_TYPE_NONE));
+
+	_noti_db_schedule(type);
+}
+
+void quickpanel_noti_db_resync(void)
+{
+	int i = 0;
+
+	retif(g_db_ref <= 0, , "noti db is not initialized");
+
+	g_db_stats.resyncs++;
+
+	for (i = 0; i < QP_NOTI_DB_SLOT_MAX; i++) {
+		g_db_slots[i].dirty = 1;
+		_noti_db_count_invalidate(i);
+	}
+
+	_noti_db_schedule(NOTIFICATION_TYPE_NONE);
+}
+
+void quickpanel_noti_db_sync(void)
+{
+	retif(g_db_ref <= 0, , "noti db is not initialized");
+
+	if (!g_db_idler)
+		return;
+
+	ecore_idler_del(g_db_idler);
+	g_db_idler = NULL;
+
+	_noti_db_flush();
+}
+
+notification_list_h quickpanel_noti_db_get_list(notification_type_e type)
+{
+	return quickpanel_noti_db_get_list_head(type, -1);
+}
+
+notification_list_h quickpanel_noti_db_get_list_head(notification_type_e type,
+						int count)
+{
+	int slot = 0;
+
+	retif(g_db_ref <= 0, NULL, "noti db is not initialized");
+	retif(type < NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX,
+		NULL, "Invalid parameter!");
+
+	slot = QP_NOTI_DB_SLOT(type);
+	if (!g_db_slots[slot].active) {
+		if (_noti_db_read(slot, count) != QP_OK)
+			return NULL;
+
+		/* read the rest once the main loop is idle */
+		if (g_db_slots[slot].partial)
+			_noti_db_schedule_flush();
+
+		g_db_slots[slot].active = 1;
+
+		if (!g_db_index)
+			g_db_index = g_hash_table_new_full(g_str_hash,
+					g_str_equal, free, NULL);
+		_noti_db_index_list(g_db_index, g_db_slots[slot].list);
+	}
+
+	return g_db_slots[slot].list;
+}
+
+notification_h quickpanel_noti_db_get_latest(notification_type_e type)
+{
+	notification_list_h get_list = NULL;
+	notification_h noti = NULL;
+	notification_type_e noti_type = NOTIFICATION_TYPE_NONE;
+	noti_db_slot *all = NULL;
+
+	retif(g_db_ref <= 0, NULL, "noti db is not initialized");
+	retif(type < NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX,
+		NULL, "Invalid parameter!");
+
+	all = &g_db_slots[QP_NOTI_DB_SLOT(NOTIFICATION_TYPE_NONE)];
+
+	/* lists are ordered newest first, the first one of the type wins */
+	if (!g_db_slots[QP_NOTI_DB_SLOT(type)].active && all->active) {
+		get_list = notification_list_get_head(all->list);
+		while (get_list != NULL) {
+			noti = notification_list_get_data(get_list);
+			get_list = notification_list_get_next(get_list);
+
+			notification_get_type(noti, &noti_type);
+			if (type == NOTIFICATION_TYPE_NONE || noti_type == type)
+				return noti;
+		}
+
+		return NULL;
+	}
+
+	get_list = notification_list_get_head(
+			quickpanel_noti_db_get_list(type));
+
+	return notification_list_get_data(get_list);
+}
+
+notification_h quickpanel_noti_db_find(const char *key)
+{
+	retif(g_db_ref <= 0, NULL, "noti db is not initialized");
+	retif(key == NULL, NULL, "Invalid parameter!");
+
+	if (!g_db_index)
+		return NULL;
+
+	return g_hash_table_lookup(g_db_index, key);
+}
+
+const qp_noti_db_app *quickpanel_noti_db_get_app(notification_type_e type,
+						const char *pkgname)
+{
+	noti_db_slot *slot = NULL;
+
+	retif(g_db_ref <= 0, NULL, "noti db is not initialized");
+	retif(pkgname == NULL, NULL, "Invalid parameter!");
+	retif(type < NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX,
+		NULL, "Invalid parameter!");
+
+	slot = &g_db_slots[QP_NOTI_DB_SLOT(type)];
+	if (!slot->active || !slot->apps)
+		return NULL;
+
+	return g_hash_table_lookup(slot->apps, pkgname);
+}
+
+int quickpanel_noti_db_get_total(notification_type_e type)
+{
+	noti_db_slot *slot = NULL;
+	int count = 0;
+
+	retif(g_db_ref <= 0, 0, "noti db is not initialized");
+	retif(type < NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX,
+		0, "Invalid parameter!");
+
+	slot = &g_db_slots[QP_NOTI_DB_SLOT(type)];
+	if (slot->active && !slot->partial)
+		return slot->total;
+
+	/* list not read to its end, the store counts */
+	quickpanel_noti_db_get_count(type, NULL, NOTIFICATION_GROUP_ID_NONE,
+				NOTIFICATION_PRIV_ID_NONE, &count);
+
+	return count;
+}
+
+void quickpanel_noti_db_foreach_app(notification_type_e type,
+				qp_noti_db_app_cb cb, void *data)
+{
+	noti_db_slot *slot = NULL;
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+
+	retif(g_db_ref <= 0, , "noti db is not initialized");
+	retif(cb == NULL, , "Invalid parameter!");
+	retif(type < NOTIFICATION_TYPE_NONE || type >= NOTIFICATION_TYPE_MAX,
+		, "Invalid parameter!");
+
+	slot = &g_db_slots[QP_NOTI_DB_SLOT(type)];
+	if (!slot->active || !slot->apps)
+		return;
+
+	g_hash_table_iter_init(&iter, slot->apps);
+	while (g_hash_table_iter_next(&iter, &key, &value))
+		cb(data, key, value);
+}
+
+int quickpanel_noti_db_add_listener(qp_noti_db_changed_cb cb, void *data)
+{
+	noti_db_listener *listener = NULL;
+
+	retif(cb == NULL, QP_FAIL, "Invalid parameter!");
+
+	listener = calloc(1, sizeof(noti_db_listener));
+	retif(listener == NULL, QP_FAIL, "fail to alloc listener");
+
+	listener->cb = cb;
+	listener->data = data;
+
+	g_db_listeners = eina_list_append(g_db_listeners, listener);
+
+	return QP_OK;
+}
+
+void quickpanel_noti_db_del_listener(qp_noti_db_changed_cb cb, void *data)
+{
+	Eina_List *l = NULL;
+	Eina_List *l_next = NULL;
+	noti_db_listener *listener = NULL;
+
+	EINA_LIST_FOREACH_SAFE(g_db_listeners, l, l_next, listener) {
+		if (listener->cb == cb && listener->data == data) {
+			g_db_listeners = eina_list_remove_list(g_db_listeners,
+								l);
+			free(listener);
+		}
+	}
+}
+
+static void _noti_db_clear(void)
+{
+	int i = 0;
+
+	for (i = 0; i < QP_NOTI_DB_SLOT_MAX; i++) {
+		if (g_db_slots[i].list)
+			g_db_backend->free_list(g_db_slots[i].list);
+
+		g_db_slots[i].list = NULL;
+		g_db_slots[i].active = 0;
+		g_db_slots[i].dirty = 0;
+		g_db_slots[i].partial = 0;
+
+		if (g_db_slots[i].counts) {
+			g_hash_table_destroy(g_db_slots[i].counts);
+			g_db_slots[i].counts = NULL;
+		}
+
+		if (g_db_slots[i].apps) {
+			g_hash_table_destroy(g_db_slots[i].apps);
+			g_db_slots[i].apps = NULL;
+		}
+		g_db_slots[i].total = 0;
+	}
+
+	if (g_db_index) {
+		g_hash_table_destroy(g_db_index);
+		g_db_index = NULL;
+	}
+}
+
+void quickpanel_noti_db_set_backend(const qp_noti_db_backend *backend)
+{
+	/* lists must be released by the backend that made them */
+	_noti_db_clear();
+
+	if (backend && backend->get_list && backend->free_list
+	    && backend->get_count)
+		g_db_backend = backend;
+	else
+		g_db_backend = &g_db_default_backend;
+}
+
+void quickpanel_noti_db_get_stats(qp_noti_db_stats *stats)
+{
+	retif(stats == NULL, , "Invalid parameter!");
+
+	*stats = g_db_stats;
+}
+
+void quickpanel_noti_db_init(void)
+{
+	if (g_db_ref++ > 0)
+		return;
+
+	memset(&g_db_stats, 0x00, sizeof(g_db_stats));
+	g_db_changed_pending = 0;
+
+	notification_resister_changed_cb(_noti_db_changed_cb, NULL);
+}
+
+void quickpanel_noti_db_fini(void)
+{
+	noti_db_listener *listener = NULL;
+
+	if (g_db_ref <= 0 || --g_db_ref > 0)
+		return;
+
+	notification_unresister_changed_cb(_noti_db_changed_cb);
+
+	if (g_db_idler) {
+		ecore_idler_del(g_db_idler);
+		g_db_idler = NULL;
+	}
+
+	EINA_LIST_FREE(g_db_listeners, listener)
+		free(listener);
+
+	_noti_db_clear();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QP_NOTI_DB_H__
+#define __QP_NOTI_DB_H__
+
+#include <notification.h>
+
+typedef struct _qp_noti_db_delta {
+	/* notifications that were not mirrored before */
+	int inserted;
+	/* mirrored notifications gone from the store */
+	int deleted;
+	/* store changed, 0 when only the rest of a partial read came in */
+	int changed;
+} qp_noti_db_delta;
+
+typedef struct _qp_noti_db_stats {
+	unsigned int changes;
+	unsigned int refreshes;
+	unsigned int reads;
+	unsigned int resyncs;
+	unsigned int count_hits;
+	unsigned int count_misses;
+} qp_noti_db_stats;
+
+/* notifications of one app in a mirrored list, as the tray shows them */
+typedef struct _qp_noti_db_app {
+	int count;
+	/* newest one, owned by the mirrored list */
+	notification_h latest;
+	/* rank of the app in the list, by its newest notification */
+	int order;
+} qp_noti_db_app;
+
+typedef void (*qp_noti_db_app_cb)(void *data, const char *pkgname,
+				const qp_noti_db_app *app);
+
+/* store access, replaceable to run the mirror against a fake store */
+typedef struct _qp_noti_db_backend {
+	notification_error_e (*get_list)(notification_type_e type, int count,
+					notification_list_h *list);
+	notification_error_e (*free_list)(notification_list_h list);
+	notification_error_e (*get_count)(notification_type_e type,
+					const char *pkgname, int group_id,
+					int priv_id, int *count);
+} qp_noti_db_backend;
+
+/*
+ * type is the notification type that changed,
+ * NOTIFICATION_TYPE_NONE if several types were refreshed at once
+ */
+typedef void (*qp_noti_db_changed_cb)(void *data, notification_type_e type,
+					const qp_noti_db_delta *delta);
+
+void quickpanel_noti_db_init(void);
+void quickpanel_noti_db_fini(void);
+
+void quickpanel_noti_db_set_backend(const qp_noti_db_backend *backend);
+
+/* mirrored list of the type, owned by the mirror */
+notification_list_h quickpanel_noti_db_get_list(notification_type_e type);
+/*
+ * same, a type not mirrored yet is read up to count items first and
+ * listeners are called with an empty delta once the rest is read
+ */
+notification_list_h quickpanel_noti_db_get_list_head(notification_type_e type,
+						int count);
+
+/*
+ * newest mirrored notification of the type, from the list of the type or
+ * from the list of every type if only that one is mirrored
+ */
+notification_h quickpanel_noti_db_get_latest(notification_type_e type);
+
+/* mirrored notification with the node key, NULL if no list has it */
+notification_h quickpanel_noti_db_find(const char *key);
+
+/*
+ * per app counts of a mirrored list, kept as the list is read so callers
+ * do not walk it again, NULL until the type is mirrored
+ */
+const qp_noti_db_app *quickpanel_noti_db_get_app(notification_type_e type,
+						const char *pkgname);
+void quickpanel_noti_db_foreach_app(notification_type_e type,
+				qp_noti_db_app_cb cb, void *data);
+
+/*
+ * notifications of the type in the store, grouped ones included, summed as
+ * the list is read, a store count while only its head is mirrored
+ */
+int quickpanel_noti_db_get_total(notification_type_e type);
+
+/* notification_get_count() answered from a cache dropped on changes */
+notification_error_e quickpanel_noti_db_get_count(notification_type_e type,
+					const char *pkgname, int group_id,
+					int priv_id, int *count);
+
+void quickpanel_noti_db_changed(notification_type_e type);
+void quickpanel_noti_db_resync(void);
+/* applies pending changes now instead of once the main loop is idle */
+void quickpanel_noti_db_sync(void);
+
+int quickpanel_noti_db_add_listener(qp_noti_db_changed_cb cb, void *data);
+void quickpanel_noti_db_del_listener(qp_noti_db_changed_cb cb, void *data);
+
+void quickpanel_noti_db_get_stats(qp_noti_db_stats *stats);
+
+#endif /* __QP_NOTI_DB_H__ */
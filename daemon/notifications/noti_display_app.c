@@ -20,6 +20,7 @@
 #include "noti_win.h"
 #include "quickpanel-ui.h"
 #include "noti_display_app.h"
+#include "icon_cache.h"
 
 #define INFO(str, args...) fprintf(stdout, str"\n", ##args)
 #define ERR(str, args...) fprintf(stderr, str"\n", ##args)
@@ -248,7 +249,7 @@ static void _noti_show(E_Notification *n, enum Noti_Orient orient,
 	if (path_icon) {
 		INFO("%s", path_icon);
 		icon = elm_icon_add(layout);
-		if (elm_icon_file_set(icon, path_icon, NULL)) {
+		if (quickpanel_icon_cache_file_set(icon, path_icon, 0)) {
 			elm_icon_resizable_set(icon, EINA_TRUE, EINA_TRUE);
 			elm_object_part_content_set(layout, "icon", icon);
 		}
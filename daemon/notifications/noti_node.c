@@ -0,0 +1,287 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <glib.h>
+#include <notification.h>
+
+#include "common.h"
+#include "mempool.h"
+#include "noti_node.h"
+
+/* nodes and snapshots kept for reuse across list rebuilds */
+#define QP_NOTI_NODE_POOL_MAX	128
+
+static GHashTable *g_noti_node_table;
+static unsigned int g_noti_node_gen;
+static qp_mempool *g_noti_node_pool;
+static qp_mempool *g_noti_render_pool;
+
+static void _noti_node_render_free(noti_node_render *render)
+{
+	if (!render)
+		return;
+
+	free(render->title);
+	free(render->content);
+	free(render->group_title);
+	free(render->group_content);
+	free(render->time);
+	free(render->icon_path);
+	free(render->thumbnail_path);
+	quickpanel_mempool_free(g_noti_render_pool, render);
+}
+
+static void _noti_node_item_free(noti_node_item *node)
+{
+	if (!node)
+		return;
+
+	if (node->view)
+		WARN("node[%s] is freed while shown", node->key);
+
+	_noti_node_render_free(node->render);
+	free(node->more_label);
+	free(node->more_icon_path);
+
+	if (node->key)
+		free(node->key);
+
+	quickpanel_mempool_free(g_noti_node_pool, node);
+}
+
+void quickpanel_noti_node_init(void)
+{
+	if (g_noti_node_table)
+		return;
+
+	g_noti_node_pool = quickpanel_mempool_new("noti_node_item",
+			sizeof(noti_node_item), QP_NOTI_NODE_POOL_MAX);
+	g_noti_render_pool = quickpanel_mempool_new("noti_node_render",
+			sizeof(noti_node_render), QP_NOTI_NODE_POOL_MAX);
+
+	/* key is owned by the node */
+	g_noti_node_table = g_hash_table_new_full(g_str_hash, g_str_equal,
+				NULL, (GDestroyNotify)_noti_node_item_free);
+}
+
+void quickpanel_noti_node_fini(void)
+{
+	if (!g_noti_node_table)
+		return;
+
+	g_hash_table_destroy(g_noti_node_table);
+	g_noti_node_table = NULL;
+
+	quickpanel_mempool_destroy(g_noti_render_pool);
+	g_noti_render_pool = NULL;
+	quickpanel_mempool_destroy(g_noti_node_pool);
+	g_noti_node_pool = NULL;
+}
+
+char *quickpanel_noti_node_make_key(notification_h noti, char *buf,
+					int buf_len)
+{
+	char *pkgname = NULL;
+	int priv_id = 0;
+
+	retif(noti == NULL, NULL, "Invalid parameter!");
+
+	notification_get_pkgname(noti, &pkgname);
+	notification_get_id(noti, NULL, &priv_id);
+	retif(pkgname == NULL, NULL, "pkgname is NULL");
+
+	return quickpanel_noti_node_make_key_by_id(pkgname, priv_id,
+						buf, buf_len);
+}
+
+char *quickpanel_noti_node_make_key_by_id(const char *pkgname, int priv_id,
+					char *buf, int buf_len)
+{
+	retif(pkgname == NULL, NULL, "Invalid parameter!");
+
+	if (snprintf(buf, buf_len, "%s:%d", pkgname, priv_id) <= 0)
+		return NULL;
+
+	return buf;
+}
+
+noti_node_item *quickpanel_noti_node_add(const char *key,
+					notification_h noti)
+{
+	noti_node_item *node = NULL;
+
+	retif(!g_noti_node_table, NULL, "node table is NULL");
+	retif(key == NULL, NULL, "Invalid parameter!");
+
+	node = g_hash_table_lookup(g_noti_node_table, key);
+	if (node) {
+		node->noti = noti;
+		return node;
+	}
+
+	node = quickpanel_mempool_alloc(g_noti_node_pool);
+	retif(node == NULL, NULL, "fail to alloc node");
+
+	node->key = strdup(key);
+	if (!node->key) {
+		ERR("fail to alloc key");
+		quickpanel_mempool_free(g_noti_node_pool, node);
+		return NULL;
+	}
+	node->noti = noti;
+	node->gen = g_noti_node_gen;
+
+	g_hash_table_insert(g_noti_node_table, node->key, node);
+
+	return node;
+}
+
+noti_node_item *quickpanel_noti_node_get_by_key(const char *key)
+{
+	if (!g_noti_node_table || !key)
+		return NULL;
+
+	return g_hash_table_lookup(g_noti_node_table, key);
+}
+
+noti_node_item *quickpanel_noti_node_get(const char *pkgname, int priv_id)
+{
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+
+	if (!quickpanel_noti_node_make_key_by_id(pkgname, priv_id,
+						buf, sizeof(buf)))
+		return NULL;
+
+	return quickpanel_noti_node_get_by_key(buf);
+}
+
+static void _noti_node_mark_list(notification_list_h noti_list)
+{
+	notification_list_h get_list = NULL;
+	notification_h noti = NULL;
+	noti_node_item *node = NULL;
+	char buf[QP_NOTI_NODE_KEY_LEN] = { 0, };
+	char *key = NULL;
+
+	get_list = notification_list_get_head(noti_list);
+	while (get_list != NULL) {
+		noti = notification_list_get_data(get_list);
+		get_list = notification_list_get_next(get_list);
+
+		key = quickpanel_noti_node_make_key(noti, buf, sizeof(buf));
+		if (!key)
+			continue;
+
+		/*
+		 * nodes are added by the reconcile pass for shown items only,
+		 * collapsed notifications are not indexed
+		 */
+		node = g_hash_table_lookup(g_noti_node_table, key);
+		if (!node || !node->view)
+			continue;
+
+		/* first occurrence wins, like on the genlist */
+		if (node->gen != g_noti_node_gen) {
+			/* shown nodes are checked when reconciled */
+			if (node->noti != noti)
+				node->stale = 1;
+
+			node->noti = noti;
+			node->gen = g_noti_node_gen;
+		}
+	}
+}
+
+static gboolean _noti_node_is_old(gpointer key, gpointer value,
+				gpointer user_data)
+{
+	noti_node_item *node = value;
+
+	/*
+	 * items not backed by a notification live as long as their view,
+	 * the view keeps its snapshot until the list is reconciled
+	 */
+	if (node->view) {
+		if (node->gen != g_noti_node_gen) {
+			node->noti = NULL;
+			node->stale = 1;
+		}
+		return FALSE;
+	}
+
+	return (node->gen != g_noti_node_gen) ? TRUE : FALSE;
+}
+
+void quickpanel_noti_node_sync(notification_list_h ongoing_list,
+				notification_list_h noti_list)
+{
+	guint removed = 0;
+
+	retif(!g_noti_node_table, , "node table is NULL");
+
+	g_noti_node_gen++;
+
+	_noti_node_mark_list(ongoing_list);
+	_noti_node_mark_list(noti_list);
+
+	removed = g_hash_table_foreach_remove(g_noti_node_table,
+				_noti_node_is_old, NULL);
+
+	DBG("nodes:%d removed:%d",
+		g_hash_table_size(g_noti_node_table), removed);
+}
+
+int quickpanel_noti_node_get_count(void)
+{
+	if (!g_noti_node_table)
+		return 0;
+
+	return g_hash_table_size(g_noti_node_table);
+}
+
+noti_node_render *quickpanel_noti_node_render_new(void)
+{
+	retif(g_noti_render_pool == NULL, NULL, "node is not initialized");
+
+	return quickpanel_mempool_alloc(g_noti_render_pool);
+}
+
+void quickpanel_noti_node_set_render(noti_node_item *node,
+				noti_node_render *render)
+{
+	retif(node == NULL, , "Invalid parameter!");
+
+	if (node->render == render)
+		return;
+
+	_noti_node_render_free(node->render);
+	node->render = render;
+}
+
+static void _noti_node_reset_render(gpointer key, gpointer value,
+				gpointer user_data)
+{
+	quickpanel_noti_node_set_render(value, NULL);
+}
+
+void quickpanel_noti_node_reset_render(void)
+{
+	if (!g_noti_node_table)
+		return;
+
+	g_hash_table_foreach(g_noti_node_table, _noti_node_reset_render, NULL);
+}
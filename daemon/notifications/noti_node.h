@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QP_NOTI_NODE_H__
+#define __QP_NOTI_NODE_H__
+
+#include <Elementary.h>
+#include <notification.h>
+
+#define QP_NOTI_NODE_KEY_LEN	256
+
+/* resolved fields of a notification for the genlist callbacks */
+typedef struct _noti_node_render {
+	notification_type_e type;
+	int count;
+	int is_message;
+	int has_time;
+	double progress;
+	double size;
+	char *title;
+	char *content;
+	char *group_title;
+	char *group_content;
+	/* time of a noti, progress of an ongoing one */
+	char *time;
+	char *icon_path;
+	char *thumbnail_path;
+} noti_node_render;
+
+typedef struct _noti_node_item {
+	char *key;
+	notification_h noti;
+	Elm_Object_Item *view;
+	/* pooled contents of the realized view, if any */
+	Evas_Object *progress;
+	Evas_Object *icon;
+	Evas_Object *thumbnail;
+	/* built on demand, dropped when the notification changes */
+	noti_node_render *render;
+	/* notification replaced while the view was left as is */
+	int stale;
+	/* overflow aggregate, kept to rebuild its snapshot */
+	int more;
+	char *more_label;
+	char *more_icon_path;
+
+	/* internal data */
+	unsigned int gen;
+} noti_node_item;
+
+void quickpanel_noti_node_init(void);
+void quickpanel_noti_node_fini(void);
+
+char *quickpanel_noti_node_make_key(notification_h noti, char *buf,
+					int buf_len);
+char *quickpanel_noti_node_make_key_by_id(const char *pkgname, int priv_id,
+					char *buf, int buf_len);
+
+noti_node_item *quickpanel_noti_node_add(const char *key,
+					notification_h noti);
+noti_node_item *quickpanel_noti_node_get(const char *pkgname, int priv_id);
+noti_node_item *quickpanel_noti_node_get_by_key(const char *key);
+
+/* refresh the nodes shown on the list from the given lists,
+ * drop the others */
+void quickpanel_noti_node_sync(notification_list_h ongoing_list,
+				notification_list_h noti_list);
+
+int quickpanel_noti_node_get_count(void);
+
+/* zeroed snapshot, owned by the node once set */
+noti_node_render *quickpanel_noti_node_render_new(void);
+/* replaces the snapshot of the node, NULL drops it */
+void quickpanel_noti_node_set_render(noti_node_item *node,
+				noti_node_render *render);
+void quickpanel_noti_node_reset_render(void);
+
+#endif /* __QP_NOTI_NODE_H__ */
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <Elementary.h>
+
+#include "common.h"
+#include "noti_pool.h"
+
+#define QP_NOTI_POOL_TYPE_KEY	"qp_noti_pool_type"
+
+static Evas_Object *g_pool_parent;
+static Eina_List *g_pool[QP_NOTI_POOL_MAX];
+static int g_pool_count[QP_NOTI_POOL_MAX];
+static int g_pool_rows = 1;
+static qp_noti_pool_stats g_pool_stats;
+
+/* a noti row shows an icon and a thumbnail, an ongoing one a progressbar */
+static const int g_pool_per_row[QP_NOTI_POOL_MAX] = { 2, 1, 1 };
+
+static int _noti_pool_size(qp_noti_pool_type_e type)
+{
+	return g_pool_rows * g_pool_per_row[type];
+}
+
+static Evas_Object *_noti_pool_create(qp_noti_pool_type_e type)
+{
+	Evas_Object *obj = NULL;
+
+	switch (type) {
+	case QP_NOTI_POOL_ICON:
+		obj = elm_icon_add(g_pool_parent);
+		break;
+	case QP_NOTI_POOL_PROGRESS:
+		obj = elm_progressbar_add(g_pool_parent);
+		if (obj) {
+			elm_object_style_set(obj, "list_progress");
+			elm_progressbar_horizontal_set(obj, EINA_TRUE);
+			elm_progressbar_pulse(obj, EINA_FALSE);
+		}
+		break;
+	case QP_NOTI_POOL_PENDING:
+		obj = elm_progressbar_add(g_pool_parent);
+		if (obj) {
+			elm_object_style_set(obj, "pending_list");
+			elm_progressbar_horizontal_set(obj, EINA_TRUE);
+		}
+		break;
+	default:
+		break;
+	}
+	retif(obj == NULL, NULL, "fail to create pool object[%d]", type);
+
+	evas_object_data_set(obj, QP_NOTI_POOL_TYPE_KEY,
+			(void *)(type + 1));
+
+	/* keeps the object alive across genlist unrealize */
+	evas_object_ref(obj);
+
+	return obj;
+}
+
+static void _noti_pool_destroy(Evas_Object *obj)
+{
+	evas_object_data_del(obj, QP_NOTI_POOL_TYPE_KEY);
+	evas_object_unref(obj);
+	evas_object_del(obj);
+}
+
+static void _noti_pool_trim(qp_noti_pool_type_e type)
+{
+	Evas_Object *obj = NULL;
+
+	while (g_pool_count[type] > _noti_pool_size(type)) {
+		obj = eina_list_data_get(g_pool[type]);
+		g_pool[type] = eina_list_remove_list(g_pool[type],
+						g_pool[type]);
+		g_pool_count[type]--;
+
+		_noti_pool_destroy(obj);
+		g_pool_stats.drops++;
+	}
+}
+
+void quickpanel_noti_pool_init(Evas_Object *parent)
+{
+	retif(parent == NULL, , "Invalid parameter!");
+
+	g_pool_parent = parent;
+	memset(&g_pool_stats, 0x00, sizeof(g_pool_stats));
+}
+
+void quickpanel_noti_pool_fini(void)
+{
+	Evas_Object *obj = NULL;
+	int type = 0;
+
+	for (type = 0; type < QP_NOTI_POOL_MAX; type++) {
+		EINA_LIST_FREE(g_pool[type], obj)
+			_noti_pool_destroy(obj);
+		g_pool_count[type] = 0;
+	}
+
+	INFO("pool hits[%u] creates[%u] releases[%u] drops[%u]",
+		g_pool_stats.hits, g_pool_stats.creates,
+		g_pool_stats.releases, g_pool_stats.drops);
+
+	g_pool_parent = NULL;
+}
+
+void quickpanel_noti_pool_set_rows(int rows)
+{
+	int type = 0;
+
+	g_pool_rows = (rows > 0) ? rows : 1;
+
+	for (type = 0; type < QP_NOTI_POOL_MAX; type++)
+		_noti_pool_trim(type);
+
+	DBG("pool rows[%d]", g_pool_rows);
+}
+
+Evas_Object *quickpanel_noti_pool_get(qp_noti_pool_type_e type)
+{
+	Evas_Object *obj = NULL;
+
+	retif(type < 0 || type >= QP_NOTI_POOL_MAX, NULL, "Invalid type!");
+	retif(g_pool_parent == NULL, NULL, "pool is not initialized");
+
+	if (g_pool[type]) {
+		obj = eina_list_data_get(g_pool[type]);
+		g_pool[type] = eina_list_remove_list(g_pool[type],
+						g_pool[type]);
+		g_pool_count[type]--;
+		g_pool_stats.hits++;
+	} else {
+		obj = _noti_pool_create(type);
+		if (!obj)
+			return NULL;
+		g_pool_stats.creates++;
+	}
+
+	if (type == QP_NOTI_POOL_PENDING)
+		elm_progressbar_pulse(obj, EINA_TRUE);
+
+	return obj;
+}
+
+int quickpanel_noti_pool_get_type(Evas_Object *obj)
+{
+	retif(obj == NULL, -1, "Invalid parameter!");
+
+	return (int)evas_object_data_get(obj, QP_NOTI_POOL_TYPE_KEY) - 1;
+}
+
+void quickpanel_noti_pool_release(Evas_Object *obj)
+{
+	Evas_Object *parent = NULL;
+	int type = 0;
+
+	retif(obj == NULL, , "Invalid parameter!");
+
+	type = quickpanel_noti_pool_get_type(obj);
+	retif(type < 0 || type >= QP_NOTI_POOL_MAX, , "not a pool object");
+
+	/* leave the realized view, it may be cached by genlist */
+	parent = evas_object_smart_parent_get(obj);
+	if (parent)
+		edje_object_part_unswallow(parent, obj);
+	evas_object_hide(obj);
+
+	if (type == QP_NOTI_POOL_PENDING)
+		elm_progressbar_pulse(obj, EINA_FALSE);
+
+	g_pool_stats.releases++;
+
+	if (!g_pool_parent || g_pool_count[type] >= _noti_pool_size(type)) {
+		_noti_pool_destroy(obj);
+		g_pool_stats.drops++;
+		return;
+	}
+
+	g_pool[type] = eina_list_prepend(g_pool[type], obj);
+	g_pool_count[type]++;
+}
+
+void quickpanel_noti_pool_get_stats(qp_noti_pool_stats *stats)
+{
+	retif(stats == NULL, , "Invalid parameter!");
+
+	*stats = g_pool_stats;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QP_NOTI_POOL_H__
+#define __QP_NOTI_POOL_H__
+
+#include <Elementary.h>
+
+typedef enum _qp_noti_pool_type {
+	QP_NOTI_POOL_ICON = 0,
+	/* "list_progress" progressbar */
+	QP_NOTI_POOL_PROGRESS,
+	/* "pending_list" pulsing progressbar */
+	QP_NOTI_POOL_PENDING,
+	QP_NOTI_POOL_MAX,
+} qp_noti_pool_type_e;
+
+typedef struct _qp_noti_pool_stats {
+	/* objects handed out again */
+	unsigned int hits;
+	/* objects built because the pool was empty */
+	unsigned int creates;
+	unsigned int releases;
+	/* released over the pool size and deleted */
+	unsigned int drops;
+} qp_noti_pool_stats;
+
+void quickpanel_noti_pool_init(Evas_Object *parent);
+void quickpanel_noti_pool_fini(void);
+
+/* number of rows on screen, each row keeps its objects pooled */
+void quickpanel_noti_pool_set_rows(int rows);
+
+/*
+ * pooled objects are referenced, genlist deleting them on unrealize
+ * is deferred until they are released and dropped from the pool
+ */
+Evas_Object *quickpanel_noti_pool_get(qp_noti_pool_type_e type);
+void quickpanel_noti_pool_release(Evas_Object *obj);
+/* qp_noti_pool_type_e of a pooled object, -1 otherwise */
+int quickpanel_noti_pool_get_type(Evas_Object *obj);
+
+void quickpanel_noti_pool_get_stats(qp_noti_pool_stats *stats);
+
+#endif /* __QP_NOTI_POOL_H__ */
@@ -29,6 +29,8 @@
 #include "quickpanel-ui.h"
 #include "common.h"
 #include "noti_win.h"
+#include "noti_db.h"
+#include "icon_cache.h"
 
 #define QP_TICKER_DURATION	5
 #define QP_TICKER_DETAIL_DURATION 6
@@ -40,7 +42,8 @@ static Evas_Object *g_window;
 static Evas_Object *g_ticker;
 static Ecore_Timer *g_timer;
 static int g_noti_height;
-static notification_list_h g_latest_noti_list;
+/* copy of the notification shown, the mirror releases its lists */
+static notification_h g_latest_noti;
 static int g_svi;
 
 static int quickpanel_ticker_init(void *data);
@@ -48,6 +51,8 @@ static int quickpanel_ticker_fini(void *data);
 static int quickpanel_ticker_enter_hib(void *data);
 static int quickpanel_ticker_leave_hib(void *data);
 static void quickpanel_ticker_reflesh(void *data);
+static void quickpanel_ticker_visibility_changed(void *data,
+					qp_visibility_e state);
 
 QP_Module ticker = {
 	.name = "ticker",
@@ -56,7 +61,8 @@ QP_Module ticker = {
 	.hib_enter = quickpanel_ticker_enter_hib,
 	.hib_leave = quickpanel_ticker_leave_hib,
 	.lang_changed = NULL,
-	.refresh = quickpanel_ticker_reflesh
+	.refresh = quickpanel_ticker_reflesh,
+	.visibility_changed = quickpanel_ticker_visibility_changed,
 };
 
 static int latest_inserted_time;
@@ -129,15 +135,12 @@ static void _quickpanel_ticker_hide(void)
 		g_ticker = NULL;
 	}
 
-	if (g_latest_noti_list) {
+	if (g_latest_noti) {
 		/* delete here only ticker noti display item */
-		notification_h noti =
-			notification_list_get_data(g_latest_noti_list);
+		__ticker_only_noti_del(g_latest_noti);
 
-		__ticker_only_noti_del(noti);
-
-		notification_free_list(g_latest_noti_list);
-		g_latest_noti_list = NULL;
+		notification_free(g_latest_noti);
+		g_latest_noti = NULL;
 	}
 }
 
@@ -287,8 +290,8 @@ static Evas_Object *_quickpanel_ticker_create_icon(Evas_Object *parent,
 	icon = elm_icon_add(parent);
 
 	if (icon_path == NULL
-	    || (elm_icon_file_set(icon, icon_path, NULL) == EINA_FALSE)) {
-		elm_icon_file_set(icon, DEFAULT_ICON, NULL);
+	    || !quickpanel_icon_cache_file_set(icon, icon_path, 0)) {
+		quickpanel_icon_cache_file_set(icon, DEFAULT_ICON, 0);
 		elm_icon_resizable_set(icon, EINA_TRUE, EINA_TRUE);
 	}
 
@@ -517,7 +520,7 @@ static void _quickpanel_ticker_win_rotated(void *data) {
 
 static void _quickpanel_ticker_noti_changed_cb(void *data, notification_type_e type)
 {
-	notification_list_h noti_list = NULL;
+	notification_h latest = NULL;
 	notification_h noti = NULL;
 	notification_error_e noti_err = NOTIFICATION_ERROR_NONE;
 	int angle = 0;
@@ -529,24 +532,16 @@ static void _quickpanel_ticker_noti_changed_cb(void *data, notification_type_e t
 
 	INFO("_quickpanel_ticker_noti_changed_cb");
 
-	/* Get latest item */
-	noti_err = notification_get_grouping_list(type, 1, &noti_list);
-	if (noti_err != NOTIFICATION_ERROR_NONE) {
-		ERR("Fail to notification_get_grouping_list : %d", noti_err);
-		return;
-	}
-
-	noti = notification_list_get_data(noti_list);
-	if (noti == NULL) {
-		ERR("Fail to notification_list_get_data");
-		notification_free_list(noti_list);
+	/* Get latest item, read from the mirror */
+	latest = quickpanel_noti_db_get_latest(type);
+	if (latest == NULL) {
+		ERR("Fail to get the latest notification");
 		return;
 	}
 
-	noti_err = notification_get_insert_time(noti, &insert_time);
+	noti_err = notification_get_insert_time(latest, &insert_time);
 	if (noti_err != NOTIFICATION_ERROR_NONE) {
 		ERR("Fail to notification_get_insert_time(%d)", noti_err);
-		notification_free_list(noti_list);
 		return;
 	}
 
@@ -554,13 +549,18 @@ static void _quickpanel_ticker_noti_changed_cb(void *data, notification_type_e t
 	current_inserted_time = (int)insert_time;
 	if (latest_inserted_time >= current_inserted_time) {
 		/* delete temporary here only ticker noti display item */
-		__ticker_only_noti_del(noti);
-
-		notification_free_list(noti_list);
+		__ticker_only_noti_del(latest);
 		return;
 	}
 	latest_inserted_time = current_inserted_time;
 
+	/* kept past the next refresh of the mirror */
+	noti_err = notification_clone(latest, &noti);
+	if (noti_err != NOTIFICATION_ERROR_NONE || noti == NULL) {
+		ERR("Fail to notification_clone(%d)", noti_err);
+		return;
+	}
+
 	/* Check setting's event  notificcation */
 	ret = _quickpanel_ticker_check_setting_event_value(noti);
 	if (ret < 0) {
@@ -568,7 +568,7 @@ static void _quickpanel_ticker_noti_changed_cb(void *data, notification_type_e t
 		/* delete temporary here only ticker noti display item */
 		__ticker_only_noti_del(noti);
 
-		notification_free_list(noti_list);
+		notification_free(noti);
 		return;
 	}
 
@@ -638,6 +638,7 @@ static void _quickpanel_ticker_noti_changed_cb(void *data, notification_type_e t
 		g_ticker = _quickpanel_ticker_create_tickernoti(noti);
 		if (g_ticker == NULL) {
 			ERR("Fail to create tickernoti");
+			notification_free(noti);
 			return;
 		}
 
@@ -662,10 +663,25 @@ static void _quickpanel_ticker_noti_changed_cb(void *data, notification_type_e t
 					noti);
 	}
 
-	if (g_latest_noti_list)
-		notification_free_list(g_latest_noti_list);
+	if (g_latest_noti)
+		notification_free(g_latest_noti);
 
-	g_latest_noti_list = noti_list;
+	g_latest_noti = noti;
+}
+
+static void _quickpanel_ticker_noti_db_changed_cb(void *data,
+					notification_type_e type,
+					const qp_noti_db_delta *delta)
+{
+	/* rest of a partial read, the store did not change */
+	if (delta && !delta->changed)
+		return;
+
+	/*
+	 * updates keep their pkgname:priv_id but get a new insert time,
+	 * the latest insert time decides if a ticker is raised
+	 */
+	_quickpanel_ticker_noti_changed_cb(data, type);
 }
 
 /*****************************************************************************
@@ -680,7 +696,8 @@ static int quickpanel_ticker_init(void *data)
 	latest_inserted_time = time(NULL);
 	g_window = ad->win;
 
-	notification_resister_changed_cb(_quickpanel_ticker_noti_changed_cb,
+	quickpanel_noti_db_init();
+	quickpanel_noti_db_add_listener(_quickpanel_ticker_noti_db_changed_cb,
 					data);
 
 	return QP_OK;
@@ -688,6 +705,10 @@ static int quickpanel_ticker_init(void *data)
 
 static int quickpanel_ticker_fini(void *data)
 {
+	quickpanel_noti_db_del_listener(_quickpanel_ticker_noti_db_changed_cb,
+					data);
+	quickpanel_noti_db_fini();
+
 	_quickpanel_ticker_hide();
 
 	if (g_svi != 0) {
@@ -716,3 +737,27 @@ static void quickpanel_ticker_reflesh(void *data)
 		_quickpanel_ticker_win_rotated(data);
 	}
 }
+
+static void quickpanel_ticker_visibility_changed(void *data,
+					qp_visibility_e state)
+{
+	notification_h noti = NULL;
+	int applist = NOTIFICATION_DISPLAY_APP_ALL;
+
+	if (state != QP_VISIBILITY_OPENING || !g_ticker || !g_latest_noti)
+		return;
+
+	/* ticker only notifications stay until they time out */
+	noti = g_latest_noti;
+	notification_get_display_applist(noti, &applist);
+	if (!(applist & NOTIFICATION_DISPLAY_APP_NOTIFICATION_TRAY))
+		return;
+
+	/* the notification is on the opened list, drop the ticker early */
+	if (g_timer) {
+		ecore_timer_del(g_timer);
+		g_timer = NULL;
+	}
+
+	_quickpanel_ticker_hide();
+}
@@ -32,17 +32,34 @@
 #include "common.h"
 #include "quickpanel-ui.h"
 #include "modules.h"
+#include "icon_cache.h"
+#include "list_util.h"
+#include "mempool.h"
 #include "notifications/noti_display_app.h"
 #include "quickpanel_def.h"
+#ifdef QP_SELFTEST
+#include <time.h>
+#include "quickpanel_noti_db_test.h"
+#include "quickpanel_list_util_bench.h"
+#include "notifications/noti.h"
+#endif /* QP_SELFTEST */
 
 #define HIBERNATION_ENTER_NOTI	"HIBERNATION_ENTER"
 #define HIBERNATION_LEAVE_NOTI	"HIBERNATION_LEAVE"
 
 #define QP_WINDOW_PRIO 300
 
+/* decoded icons kept while paused, most recent ones first */
+#define QP_ICON_CACHE_PAUSE_BYTES	(1024 * 1024)
+
 /* heynoti handle */
 static int g_hdl_heynoti;
 
+/* panel visibility, fed by the illume quickpanel state */
+static Ecore_Idler *g_visibility_idler;
+static double g_visibility_on_time;
+static qp_visibility_stats g_visibility_stats;
+
 /* binary information */
 #define QP_EMUL_STR		"i686_emulated"
 
@@ -59,6 +76,8 @@ static void _hibernation_enter_cb(void *data)
 
 	INFO(" >>>>>>>>>>>>>>> ENTER HIBERNATION!! <<<<<<<<<<<<<<<< ");
 	hib_enter_modules(data);
+	quickpanel_icon_cache_trim(0);
+	quickpanel_mempool_trim_all();
 	if (ad)
 		common_cache_flush(ad->evas);
 }
@@ -69,6 +88,93 @@ static void _hibernation_leave_cb(void *data)
 	INFO(" >>>>>>>>>>>>>>> LEAVE HIBERNATION!! <<<<<<<<<<<<<<<< ");
 }
 
+/******************************************************************************
+  *
+  * VISIBILITY
+  *
+  ****************************************************************************/
+
+static void _quickpanel_ui_visibility_set(struct appdata *ad,
+					qp_visibility_e state)
+{
+	if (ad->visibility == state)
+		return;
+
+	DBG("visibility %d -> %d", ad->visibility, state);
+
+	ad->visibility = state;
+	visibility_change_modules(ad, state);
+}
+
+/* work triggered by the illume message is done once the loop is idle */
+static Eina_Bool _quickpanel_ui_visibility_idler_cb(void *data)
+{
+	struct appdata *ad = data;
+	double latency = 0.0;
+
+	g_visibility_idler = NULL;
+
+	retif(ad == NULL, ECORE_CALLBACK_CANCEL, "Invalid parameter!");
+
+	if (ad->visibility == QP_VISIBILITY_OPENING) {
+		latency = ecore_time_get() - g_visibility_on_time;
+
+		g_visibility_stats.open_latency_last = latency;
+		g_visibility_stats.open_latency_total += latency;
+		if (latency > g_visibility_stats.open_latency_max)
+			g_visibility_stats.open_latency_max = latency;
+
+		INFO("opened in %.3f sec", latency);
+
+		_quickpanel_ui_visibility_set(ad, QP_VISIBILITY_VISIBLE);
+	} else if (ad->visibility == QP_VISIBILITY_CLOSING) {
+		_quickpanel_ui_visibility_set(ad, QP_VISIBILITY_HIDDEN);
+	}
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void _quickpanel_ui_visibility_update(struct appdata *ad, int on)
+{
+	double now = ecore_time_get();
+	double open_time = 0.0;
+
+	retif(ad == NULL, , "Invalid parameter!");
+
+	if (on) {
+		if (QP_IS_OPENED(ad))
+			return;
+
+		g_visibility_on_time = now;
+		g_visibility_stats.opens++;
+
+		_quickpanel_ui_visibility_set(ad, QP_VISIBILITY_OPENING);
+	} else {
+		if (!QP_IS_OPENED(ad))
+			return;
+
+		open_time = now - g_visibility_on_time;
+
+		g_visibility_stats.open_time_last = open_time;
+		g_visibility_stats.open_time_total += open_time;
+
+		INFO("closed after %.3f sec", open_time);
+
+		_quickpanel_ui_visibility_set(ad, QP_VISIBILITY_CLOSING);
+	}
+
+	if (!g_visibility_idler)
+		g_visibility_idler = ecore_idler_add(
+				_quickpanel_ui_visibility_idler_cb, ad);
+}
+
+void quickpanel_ui_get_visibility_stats(qp_visibility_stats *stats)
+{
+	retif(stats == NULL, , "Invalid parameter!");
+
+	*stats = g_visibility_stats;
+}
+
 /******************************************************************************
   *
   * UI
@@ -219,6 +325,11 @@ static Eina_Bool quickpanel_ui_client_message_cb(void *data, int type,
 			}
 		}
 		ecore_idler_add(quickpanel_ui_refresh_cb, ad);
+	} else if (ev->message_type == ECORE_X_ATOM_E_ILLUME_QUICKPANEL_STATE) {
+		if (ev->data.l[0] == ECORE_X_ATOM_E_ILLUME_QUICKPANEL_ON)
+			_quickpanel_ui_visibility_update(ad, 1);
+		else if (ev->data.l[0] == ECORE_X_ATOM_E_ILLUME_QUICKPANEL_OFF)
+			_quickpanel_ui_visibility_update(ad, 0);
 	}
 	return ECORE_CALLBACK_RENEW;
 }
@@ -324,6 +435,7 @@ static int _quickpanel_ui_create_win(void *data)
 	}
 	elm_genlist_homogeneous_set(ad->list, EINA_FALSE);
 	elm_object_part_content_set(ad->ly, "qp.gl_base.gl.swallow", ad->list);
+	quickpanel_list_util_set_scale(ad->list, ad->scale);
 
 	ecore_x_window_size_get(ecore_x_window_root_first_get(), &w, &h);
 	evas_object_resize(ad->win, w, h);
@@ -526,6 +638,11 @@ static void _quickpanel_ui_fini_ecore_event(struct appdata *ad)
 		ecore_event_handler_del(ad->hdl_client_message);
 		ad->hdl_client_message = NULL;
 	}
+
+	if (g_visibility_idler) {
+		ecore_idler_del(g_visibility_idler);
+		g_visibility_idler = NULL;
+	}
 }
 static int _quickpanel_ui_check_emul(void)
 {
@@ -557,6 +674,9 @@ extern QP_Module minictrl;
 #endif /* QP_MINICTRL_ENABLE */
 extern QP_Module noti;
 
+/* last region set, -1 when the geometry has to be set again */
+static int g_contents_height = -1;
+
 static void _quickpanel_ui_update_height(void *data)
 {
 	int contents_height = 0;
@@ -579,6 +699,11 @@ static void _quickpanel_ui_update_height(void *data)
 
 	contents_height = ad->gl_distance_from_top + height_genlist + ad->gl_distance_to_bottom - ad->scale * QP_HANDLE_H;
 
+	/* heights are summed up as items come and go, nothing to redo */
+	if (contents_height == g_contents_height)
+		return;
+	g_contents_height = contents_height;
+
 	DBG("height_genlist:%d\n gl_distance_from_top:%d\n gl_distance_to_bottom:%d\n gl_limit_height:%d\nnew_height:%d"
 			,height_genlist
 			,ad->gl_distance_from_top
@@ -591,18 +716,9 @@ static void _quickpanel_ui_update_height(void *data)
 	quickpanel_ui_window_set_content_region(ad, contents_height);
 }
 
-static Eina_Bool quickpanel_ui_update_height_handler(void *data)
-{
-	_quickpanel_ui_update_height(data);
-	DBG("ui height updated in idler");
-
-	return EINA_FALSE;
-}
-
 void quickpanel_ui_update_height(void *data)
 {
 	_quickpanel_ui_update_height(data);
-	ecore_idler_add(quickpanel_ui_update_height_handler, data); // workaround(minicontrol)
 }
 
 void quickpanel_init_size_genlist(void *data)
@@ -630,6 +746,9 @@ void quickpanel_init_size_genlist(void *data)
 	ad->gl_distance_to_bottom = spn_height + (1 * ad->scale) + (ad->scale*QP_HANDLE_H) ;
 	ad->gl_limit_height = max_height_window - ad->gl_distance_from_top - ad->gl_distance_to_bottom;
 
+	/* rotated or resized, regions are set again */
+	g_contents_height = -1;
+
 	DBG("\nwin_angle:%d\nwin height:%d\n gl_distance_from_top:%d\n gl_distance_to_bottom:%d\n gl_limit_height:%d\n"
 			,ad->angle
 			,max_height_window
@@ -709,6 +828,8 @@ static void quickpanel_app_terminate(void *data)
 	/* fini quickpanel modules */
 	fini_modules(ad);
 
+	quickpanel_icon_cache_fini();
+
 	common_cache_flush(ad->evas);
 
 	/* unregister system event callback */
@@ -733,6 +854,21 @@ static void quickpanel_app_pause(void *data)
 
 	suspend_modules(ad);
 
+	quickpanel_icon_cache_trim(QP_ICON_CACHE_PAUSE_BYTES);
+
+	common_cache_flush(ad->evas);
+}
+
+static void quickpanel_app_low_memory_cb(void *data)
+{
+	struct appdata *ad = data;
+	retif(ad == NULL, , "invalid data.");
+
+	INFO(" >>>>>>>>>>>>>>> LOW MEMORY!! <<<<<<<<<<<<<<<< ");
+
+	quickpanel_icon_cache_trim(0);
+	quickpanel_mempool_trim_all();
+
 	common_cache_flush(ad->evas);
 }
 
@@ -780,6 +916,15 @@ static void quickpanel_app_service(service_h service, void *data)
 	_quickpanel_ui_setting_show(ad, 0);
 #endif /* QP_SETTING_ENABLE */
 
+	quickpanel_icon_cache_init();
+
+#ifdef QP_SELFTEST
+	quickpanel_noti_db_test_run((unsigned int)time(NULL), 200);
+	quickpanel_noti_bench_reconcile(ad->win, 150, 20);
+	quickpanel_list_util_bench_insert(ad->win, 1600);
+	quickpanel_list_util_bench_delete(ad->win, 500);
+#endif /* QP_SELFTEST */
+
 	/* init quickpanel modules */
 	init_modules(ad);
 
@@ -796,7 +941,10 @@ static void quickpanel_app_language_changed_cb(void *data)
 
 static void quickpanel_app_region_format_changed_cb(void *data)
 {
+	retif(data == NULL, , "Invalid parameter!");
+
 	INFO(" >>>>>>>>>>>>>>> region_format CHANGED!! <<<<<<<<<<<<<<<< ");
+	region_change_modules(data);
 }
 
 int main(int argc, char *argv[])
@@ -823,7 +971,7 @@ int main(int argc, char *argv[])
 	app_callback.pause = quickpanel_app_pause;
 	app_callback.resume = quickpanel_app_resume;
 	app_callback.service = quickpanel_app_service;
-	app_callback.low_memory = NULL;
+	app_callback.low_memory = quickpanel_app_low_memory_cb;
 	app_callback.low_battery = NULL;
 	app_callback.device_orientation = NULL;
 	app_callback.language_changed = quickpanel_app_language_changed_cb;
@@ -46,6 +46,28 @@
 #define STR_ATOM_WINDOW_INPUT_REGION    "_E_COMP_WINDOW_INPUT_REGION"
 #define STR_ATOM_WINDOW_CONTENTS_REGION "_E_COMP_WINDOW_CONTENTS_REGION"
 
+typedef enum {
+	QP_VISIBILITY_HIDDEN = 0,
+	QP_VISIBILITY_OPENING,
+	QP_VISIBILITY_VISIBLE,
+	QP_VISIBILITY_CLOSING,
+} qp_visibility_e;
+
+#define QP_IS_OPENED(ad) \
+	((ad)->visibility == QP_VISIBILITY_OPENING \
+	 || (ad)->visibility == QP_VISIBILITY_VISIBLE)
+
+typedef struct _qp_visibility_stats {
+	unsigned int opens;
+	/* illume ON message to the main loop going idle, in seconds */
+	double open_latency_last;
+	double open_latency_max;
+	double open_latency_total;
+	/* illume ON to OFF, in seconds */
+	double open_time_last;
+	double open_time_total;
+} qp_visibility_stats;
+
 struct appdata {
 	Evas_Object *win;
 	Evas_Object *ly;
@@ -64,6 +86,7 @@ struct appdata {
 
 	int is_emul; /* 0 : target, 1 : emul */
 	int show_setting;
+	qp_visibility_e visibility;
 
 	Ecore_Event_Handler *hdl_client_message;
 
@@ -83,6 +106,8 @@ typedef struct _QP_Module {
 	int (*hib_enter) (void *);
 	int (*hib_leave) (void *);
 	void (*lang_changed) (void *);
+	void (*region_changed) (void *);
+	void (*visibility_changed) (void *, qp_visibility_e);
 	void (*refresh) (void *);
 	unsigned int (*get_height) (void *);
 
@@ -93,5 +118,6 @@ typedef struct _QP_Module {
 
 void quickpanel_init_size_genlist(void *data);
 void quickpanel_ui_update_height(void *data);
+void quickpanel_ui_get_visibility_stats(qp_visibility_stats *stats);
 
 #endif				/* __QUICKPANEL_UI_H__ */
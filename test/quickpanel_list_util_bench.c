@@ -0,0 +1,193 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef QP_SELFTEST
+
+#include <stdlib.h>
+#include <Elementary.h>
+
+#include "common.h"
+#include "list_util.h"
+#include "quickpanel_list_util_bench.h"
+
+#define QP_LIST_BENCH_MIN_COUNT	100
+
+static void _bench_gl_del(void *data, Evas_Object *obj)
+{
+	quickpanel_list_util_item_free(data);
+}
+
+static Evas_Object *_bench_list_add(Evas_Object *win,
+				Elm_Genlist_Item_Class **itc)
+{
+	Evas_Object *list = NULL;
+
+	list = elm_genlist_add(win);
+	retif(list == NULL, NULL, "fail to add list");
+
+	*itc = elm_genlist_item_class_new();
+	if (!*itc) {
+		ERR("fail to alloc itc");
+		evas_object_del(list);
+		return NULL;
+	}
+
+	(*itc)->item_style = "notification_item";
+	(*itc)->func.del = _bench_gl_del;
+
+	return list;
+}
+
+static double _bench_insert_each(Evas_Object *list,
+				Elm_Genlist_Item_Class *itc, int count)
+{
+	qp_item_data *qid = NULL;
+	double start = 0.0;
+	int i = 0;
+
+	start = ecore_time_get();
+
+	for (i = 0; i < count; i++) {
+		qid = quickpanel_list_util_item_new(QP_ITEM_TYPE_NOTI, NULL);
+		if (!qid)
+			break;
+
+		if (!quickpanel_list_util_sort_insert(list, itc, qid, NULL,
+				ELM_GENLIST_ITEM_NONE, NULL, NULL))
+			quickpanel_list_util_item_free(qid);
+	}
+
+	return ecore_time_get() - start;
+}
+
+static double _bench_insert_bulk(Evas_Object *list,
+				Elm_Genlist_Item_Class *itc, int count)
+{
+	qp_item_entry *entries = NULL;
+	double start = 0.0;
+	double elapsed = 0.0;
+	int i = 0;
+
+	entries = calloc(count, sizeof(qp_item_entry));
+	retif(entries == NULL, 0.0, "fail to alloc entries");
+
+	start = ecore_time_get();
+
+	for (i = 0; i < count; i++) {
+		entries[i].itc = itc;
+		entries[i].qid = quickpanel_list_util_item_new(
+				QP_ITEM_TYPE_NOTI, NULL);
+		entries[i].type = ELM_GENLIST_ITEM_NONE;
+	}
+
+	quickpanel_list_util_bulk_insert(list, NULL, NULL, entries, count);
+
+	elapsed = ecore_time_get() - start;
+
+	for (i = 0; i < count; i++) {
+		if (entries[i].qid && !entries[i].it)
+			quickpanel_list_util_item_free(entries[i].qid);
+	}
+	free(entries);
+
+	return elapsed;
+}
+
+void quickpanel_list_util_bench_insert(Evas_Object *win, int max_count)
+{
+	Evas_Object *list = NULL;
+	Elm_Genlist_Item_Class *itc = NULL;
+	double each = 0.0;
+	double bulk = 0.0;
+	int count = 0;
+
+	retif(win == NULL, , "Invalid parameter!");
+	retif(quickpanel_list_util_get_first_item(QP_ITEM_TYPE_NOTI) != NULL, ,
+		"noti section is in use");
+
+	list = _bench_list_add(win, &itc);
+	retif(list == NULL, , "fail to set up bench");
+
+	/* linear when the time per item stays flat as the count doubles */
+	for (count = QP_LIST_BENCH_MIN_COUNT; count <= max_count; count *= 2) {
+		each = _bench_insert_each(list, itc, count);
+		quickpanel_list_util_item_del_by_type(list, NULL,
+				QP_ITEM_TYPE_NOTI);
+
+		bulk = _bench_insert_bulk(list, itc, count);
+		quickpanel_list_util_item_del_by_type(list, NULL,
+				QP_ITEM_TYPE_NOTI);
+
+		INFO("items[%d] each[%lf sec, %lf us/item] "
+			"bulk[%lf sec, %lf us/item]", count,
+			each, each * 1000000 / count,
+			bulk, bulk * 1000000 / count);
+	}
+
+	elm_genlist_item_class_free(itc);
+	evas_object_del(list);
+}
+
+/* what clearing the list cost before, one del and one count per item */
+static double _bench_delete_each(void)
+{
+	Elm_Object_Item *it = NULL;
+	Elm_Object_Item *prev = NULL;
+	double start = 0.0;
+
+	start = ecore_time_get();
+
+	/* a del deferred by genlist would leave the same head */
+	while ((it = quickpanel_list_util_get_first_item(
+				QP_ITEM_TYPE_NOTI)) != NULL && it != prev) {
+		elm_object_item_del(it);
+		prev = it;
+	}
+
+	return ecore_time_get() - start;
+}
+
+void quickpanel_list_util_bench_delete(Evas_Object *win, int count)
+{
+	Evas_Object *list = NULL;
+	Elm_Genlist_Item_Class *itc = NULL;
+	double each = 0.0;
+	double batch = 0.0;
+	double start = 0.0;
+
+	retif(win == NULL || count <= 0, , "Invalid parameter!");
+	retif(quickpanel_list_util_get_first_item(QP_ITEM_TYPE_NOTI) != NULL, ,
+		"noti section is in use");
+
+	list = _bench_list_add(win, &itc);
+	retif(list == NULL, , "fail to set up bench");
+
+	_bench_insert_bulk(list, itc, count);
+	each = _bench_delete_each();
+
+	_bench_insert_bulk(list, itc, count);
+	start = ecore_time_get();
+	quickpanel_list_util_item_del_range(list, QP_ITEM_TYPE_NOTI,
+			QP_ITEM_TYPE_NOTI);
+	batch = ecore_time_get() - start;
+
+	INFO("items[%d] each[%lf sec] batch[%lf sec]", count, each, batch);
+
+	elm_genlist_item_class_free(itc);
+	evas_object_del(list);
+}
+
+#endif /* QP_SELFTEST */
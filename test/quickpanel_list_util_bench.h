@@ -0,0 +1,36 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QUICKPANEL_LIST_UTIL_BENCH_H_
+#define __QUICKPANEL_LIST_UTIL_BENCH_H_
+
+#include <Elementary.h>
+
+/*
+ * Logs the time to fill a genlist added to win and never shown, item by
+ * item and as one batch, for doubling item counts up to max_count.
+ * Must run while the noti section of list_util is empty.
+ */
+extern void quickpanel_list_util_bench_insert(Evas_Object *win,
+					int max_count);
+
+/*
+ * Logs the time to delete count items of a genlist added to win, one
+ * elm_object_item_del() at a time and as one section range.
+ */
+extern void quickpanel_list_util_bench_delete(Evas_Object *win, int count);
+
+#endif				/* __QUICKPANEL_LIST_UTIL_BENCH_H_ */
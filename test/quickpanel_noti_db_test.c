@@ -0,0 +1,461 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef QP_SELFTEST
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <notification.h>
+
+#include "common.h"
+#include "notifications/noti_db.h"
+#include "quickpanel_noti_db_test.h"
+
+#define QP_NOTI_DB_TEST_OPS_MAX 8
+#define QP_NOTI_DB_TEST_PKG_LEN 64
+
+typedef struct _fake_entry {
+	notification_h noti;
+	notification_type_e type;
+	char pkgname[QP_NOTI_DB_TEST_PKG_LEN];
+} fake_entry;
+
+typedef struct _fake_listener_state {
+	int calls;
+	qp_noti_db_delta delta;
+} fake_listener_state;
+
+/* newest first, as the store lists them */
+static GQueue *g_fake_store = NULL;
+/* replaced and deleted notifications, mirror lists may still point to them */
+static GSList *g_fake_graveyard = NULL;
+static unsigned int g_fake_serial = 0;
+
+static int _fake_type_match(notification_type_e want, notification_type_e type)
+{
+	return (want == NOTIFICATION_TYPE_NONE || want == type);
+}
+
+static notification_error_e _fake_get_list(notification_type_e type,
+					int count, notification_list_h *list)
+{
+	notification_list_h result = NULL;
+	fake_entry *entry = NULL;
+	GList *l = NULL;
+	int n = 0;
+
+	retif(list == NULL, NOTIFICATION_ERROR_INVALID_DATA, "invalid list");
+
+	for (l = g_fake_store->head; l != NULL; l = l->next) {
+		entry = l->data;
+		if (!_fake_type_match(type, entry->type))
+			continue;
+
+		if (count > 0 && n >= count)
+			break;
+
+		result = notification_list_append(result, entry->noti);
+		n++;
+	}
+
+	*list = (result != NULL) ? notification_list_get_head(result) : NULL;
+
+	return NOTIFICATION_ERROR_NONE;
+}
+
+/* the store owns the notifications, only the list nodes are released */
+static notification_error_e _fake_free_list(notification_list_h list)
+{
+	list = notification_list_get_head(list);
+	while (list != NULL)
+		list = notification_list_remove(list,
+				notification_list_get_data(list));
+
+	return NOTIFICATION_ERROR_NONE;
+}
+
+static notification_error_e _fake_get_count(notification_type_e type,
+					const char *pkgname, int group_id,
+					int priv_id, int *count)
+{
+	fake_entry *entry = NULL;
+	GList *l = NULL;
+	int n = 0;
+
+	retif(count == NULL, NOTIFICATION_ERROR_INVALID_DATA, "invalid count");
+
+	for (l = g_fake_store->head; l != NULL; l = l->next) {
+		entry = l->data;
+		if (!_fake_type_match(type, entry->type))
+			continue;
+
+		if (pkgname && strcmp(pkgname, entry->pkgname))
+			continue;
+
+		n++;
+	}
+
+	*count = n;
+
+	return NOTIFICATION_ERROR_NONE;
+}
+
+static const qp_noti_db_backend g_fake_backend = {
+	.get_list = _fake_get_list,
+	.free_list = _fake_free_list,
+	.get_count = _fake_get_count,
+};
+
+static notification_h _fake_noti_new(notification_type_e type,
+					const char *pkgname)
+{
+	notification_h noti = NULL;
+	char title[QP_NOTI_DB_TEST_PKG_LEN] = { 0, };
+
+	noti = notification_create(type);
+	retif(noti == NULL, NULL, "fail to create notification");
+
+	snprintf(title, sizeof(title), "qptest %u", g_fake_serial++);
+	notification_set_pkgname(noti, pkgname);
+	notification_set_text(noti, NOTIFICATION_TEXT_TYPE_TITLE, title,
+				NULL, NOTIFICATION_VARIABLE_TYPE_NONE);
+
+	return noti;
+}
+
+static notification_type_e _fake_insert(unsigned int *seed)
+{
+	fake_entry *entry = NULL;
+
+	entry = calloc(1, sizeof(fake_entry));
+	retif(entry == NULL, NOTIFICATION_TYPE_NONE, "fail to alloc entry");
+
+	entry->type = (rand_r(seed) % 2) ? NOTIFICATION_TYPE_NOTI :
+				NOTIFICATION_TYPE_ONGOING;
+	snprintf(entry->pkgname, sizeof(entry->pkgname),
+		"org.tizen.qptest%u", g_fake_serial);
+
+	entry->noti = _fake_noti_new(entry->type, entry->pkgname);
+	if (entry->noti == NULL) {
+		free(entry);
+		return NOTIFICATION_TYPE_NONE;
+	}
+
+	g_queue_push_head(g_fake_store, entry);
+
+	return entry->type;
+}
+
+/* store moves an updated notification to the top */
+static notification_type_e _fake_update(unsigned int *seed)
+{
+	fake_entry *entry = NULL;
+	notification_h noti = NULL;
+	guint nth = 0;
+
+	nth = rand_r(seed) % g_queue_get_length(g_fake_store);
+	entry = g_queue_peek_nth(g_fake_store, nth);
+
+	noti = _fake_noti_new(entry->type, entry->pkgname);
+	retif(noti == NULL, NOTIFICATION_TYPE_NONE, "fail to update");
+
+	g_fake_graveyard = g_slist_prepend(g_fake_graveyard, entry->noti);
+	entry->noti = noti;
+
+	g_queue_pop_nth(g_fake_store, nth);
+	g_queue_push_head(g_fake_store, entry);
+
+	return entry->type;
+}
+
+static notification_type_e _fake_delete(unsigned int *seed)
+{
+	fake_entry *entry = NULL;
+	notification_type_e type = NOTIFICATION_TYPE_NONE;
+	guint nth = 0;
+
+	nth = rand_r(seed) % g_queue_get_length(g_fake_store);
+	entry = g_queue_pop_nth(g_fake_store, nth);
+
+	type = entry->type;
+	g_fake_graveyard = g_slist_prepend(g_fake_graveyard, entry->noti);
+	free(entry);
+
+	return type;
+}
+
+static GHashTable *_fake_pkgname_set(void)
+{
+	GHashTable *set = NULL;
+	fake_entry *entry = NULL;
+	GList *l = NULL;
+
+	set = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+	for (l = g_fake_store->head; l != NULL; l = l->next) {
+		entry = l->data;
+		g_hash_table_insert(set, strdup(entry->pkgname),
+					GINT_TO_POINTER(1));
+	}
+
+	return set;
+}
+
+static int _fake_set_missing(GHashTable *from, GHashTable *in)
+{
+	GHashTableIter iter;
+	gpointer key = NULL;
+	int missing = 0;
+
+	g_hash_table_iter_init(&iter, from);
+	while (g_hash_table_iter_next(&iter, &key, NULL)) {
+		if (!g_hash_table_lookup(in, key))
+			missing++;
+	}
+
+	return missing;
+}
+
+static void _fake_listener_cb(void *data, notification_type_e type,
+				const qp_noti_db_delta *delta)
+{
+	fake_listener_state *state = data;
+
+	state->calls++;
+	state->delta = *delta;
+}
+
+static int _check_list(notification_type_e type, int round)
+{
+	notification_list_h get_list = NULL;
+	fake_entry *entry = NULL;
+	GList *l = NULL;
+	int pos = 0;
+
+	get_list = notification_list_get_head(quickpanel_noti_db_get_list(type));
+
+	for (l = g_fake_store->head; l != NULL; l = l->next) {
+		entry = l->data;
+		if (!_fake_type_match(type, entry->type))
+			continue;
+
+		if (get_list == NULL) {
+			ERR("round[%d] type[%d] mirror ends at %d", round,
+				type, pos);
+			return 1;
+		}
+
+		if (notification_list_get_data(get_list) != entry->noti) {
+			ERR("round[%d] type[%d] mismatch at %d [%s]", round,
+				type, pos, entry->pkgname);
+			return 1;
+		}
+
+		get_list = notification_list_get_next(get_list);
+		pos++;
+	}
+
+	if (get_list != NULL) {
+		ERR("round[%d] type[%d] mirror has more than %d", round,
+			type, pos);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int _check_count(notification_type_e type, const char *pkgname,
+			int round)
+{
+	int count = 0;
+	int expected = 0;
+
+	quickpanel_noti_db_get_count(type, pkgname, NOTIFICATION_GROUP_ID_NONE,
+				NOTIFICATION_PRIV_ID_NONE, &count);
+	_fake_get_count(type, pkgname, NOTIFICATION_GROUP_ID_NONE,
+			NOTIFICATION_PRIV_ID_NONE, &expected);
+
+	if (count != expected) {
+		ERR("round[%d] type[%d] pkg[%s] count %d, store %d", round,
+			type, pkgname ? pkgname : "", count, expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int _check_total(notification_type_e type, int round)
+{
+	int expected = 0;
+	int total = 0;
+
+	total = quickpanel_noti_db_get_total(type);
+	_fake_get_count(type, NULL, NOTIFICATION_GROUP_ID_NONE,
+			NOTIFICATION_PRIV_ID_NONE, &expected);
+
+	if (total != expected) {
+		ERR("round[%d] type[%d] total %d, store %d", round, type,
+			total, expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+static int _check_round(unsigned int *seed, int round,
+			fake_listener_state *state)
+{
+	static const notification_type_e types[] = {
+		NOTIFICATION_TYPE_NONE,
+		NOTIFICATION_TYPE_NOTI,
+		NOTIFICATION_TYPE_ONGOING,
+	};
+	GHashTable *before = NULL;
+	GHashTable *after = NULL;
+	notification_type_e type = NOTIFICATION_TYPE_NONE;
+	fake_entry *entry = NULL;
+	int ops = 0;
+	int op = 0;
+	int inserted = 0;
+	int deleted = 0;
+	int failed = 0;
+	int i = 0;
+
+	before = _fake_pkgname_set();
+
+	ops = 1 + rand_r(seed) % QP_NOTI_DB_TEST_OPS_MAX;
+	for (i = 0; i < ops; i++) {
+		op = rand_r(seed) % 3;
+		if (g_queue_is_empty(g_fake_store))
+			op = 0;
+
+		switch (op) {
+		case 1:
+			type = _fake_update(seed);
+			break;
+		case 2:
+			type = _fake_delete(seed);
+			break;
+		default:
+			type = _fake_insert(seed);
+			break;
+		}
+
+		/* store sometimes does not say which type changed */
+		if (rand_r(seed) % 8 == 0)
+			type = NOTIFICATION_TYPE_NONE;
+
+		quickpanel_noti_db_changed(type);
+	}
+
+	state->calls = 0;
+	quickpanel_noti_db_sync();
+
+	after = _fake_pkgname_set();
+	inserted = _fake_set_missing(after, before);
+	deleted = _fake_set_missing(before, after);
+
+	if (state->calls != 1) {
+		ERR("round[%d] %d ops flushed in %d calls", round, ops,
+			state->calls);
+		failed++;
+	} else if (!state->delta.changed
+		   || state->delta.inserted != inserted
+		   || state->delta.deleted != deleted) {
+		ERR("round[%d] delta +%d -%d, store +%d -%d", round,
+			state->delta.inserted, state->delta.deleted,
+			inserted, deleted);
+		failed++;
+	}
+
+	for (i = 0; i < (int)(sizeof(types) / sizeof(types[0])); i++) {
+		failed += _check_list(types[i], round);
+		failed += _check_count(types[i], NULL, round);
+		failed += _check_total(types[i], round);
+	}
+
+	if (!g_queue_is_empty(g_fake_store)) {
+		entry = g_queue_peek_nth(g_fake_store,
+			rand_r(seed) % g_queue_get_length(g_fake_store));
+		failed += _check_count(NOTIFICATION_TYPE_NONE, entry->pkgname,
+					round);
+		failed += _check_count(entry->type, entry->pkgname, round);
+	}
+
+	g_hash_table_destroy(before);
+	g_hash_table_destroy(after);
+
+	return failed;
+}
+
+static void _fake_store_free(void)
+{
+	fake_entry *entry = NULL;
+	GSList *l = NULL;
+
+	if (g_fake_store) {
+		while ((entry = g_queue_pop_head(g_fake_store)) != NULL) {
+			notification_free(entry->noti);
+			free(entry);
+		}
+		g_queue_free(g_fake_store);
+		g_fake_store = NULL;
+	}
+
+	for (l = g_fake_graveyard; l != NULL; l = l->next)
+		notification_free(l->data);
+	g_slist_free(g_fake_graveyard);
+	g_fake_graveyard = NULL;
+}
+
+int quickpanel_noti_db_test_run(unsigned int seed, int rounds)
+{
+	fake_listener_state state = { 0, };
+	qp_noti_db_stats stats = { 0, };
+	unsigned int start = seed;
+	int failed = 0;
+	int i = 0;
+
+	g_fake_store = g_queue_new();
+	g_fake_serial = 0;
+
+	quickpanel_noti_db_init();
+	quickpanel_noti_db_set_backend(&g_fake_backend);
+	quickpanel_noti_db_add_listener(_fake_listener_cb, &state);
+
+	quickpanel_noti_db_get_list(NOTIFICATION_TYPE_NONE);
+	quickpanel_noti_db_get_list(NOTIFICATION_TYPE_NOTI);
+	quickpanel_noti_db_get_list(NOTIFICATION_TYPE_ONGOING);
+
+	for (i = 0; i < rounds; i++)
+		failed += _check_round(&seed, i, &state);
+
+	quickpanel_noti_db_get_stats(&stats);
+
+	quickpanel_noti_db_del_listener(_fake_listener_cb, &state);
+	quickpanel_noti_db_set_backend(NULL);
+	quickpanel_noti_db_fini();
+
+	_fake_store_free();
+
+	INFO("seed[%u] rounds[%d] changes[%u] refreshes[%u] reads[%u] failed[%d]",
+		start, rounds, stats.changes, stats.refreshes, stats.reads,
+		failed);
+
+	return failed;
+}
+
+#endif /* QP_SELFTEST */
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2012  Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Flora License, Version 1.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.tizenopensource.org/license
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __QUICKPANEL_NOTI_DB_TEST_H_
+#define __QUICKPANEL_NOTI_DB_TEST_H_
+
+/*
+ * Runs the noti db mirror against a fake store for rounds of random
+ * inserts, updates and deletes, and checks lists, counts and deltas after
+ * every round. Must run before any module holds on to the mirror.
+ * Returns the number of failed checks.
+ */
+extern int quickpanel_noti_db_test_run(unsigned int seed, int rounds);
+
+#endif				/* __QUICKPANEL_NOTI_DB_TEST_H_ */